@@ -1,626 +1,8822 @@
-﻿
-#include <cassert>
+﻿#include <cassert>
 #include <cstdlib>
 #include <utility>
 #include <algorithm>
 #include <stdexcept>
 #include <iostream>
 #include <numeric>
+#include <memory>
+#include <new>
+#include <cstring>
+#include <type_traits>
+#include <chrono>
+#include <memory_resource>
+#include <array>
+#include <tuple>
+#include <cstddef>
+#include <iterator>
+#include <sstream>
+#include <fstream>
+#include <limits>
+#include <cstdint>
+#include <future>
+#include <condition_variable>
+#include <queue>
+#include <thread>
+#include <vector>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <random>
+#include <atomic>
+#include <mutex>
+#include <exception>
+#include <typeinfo>
+#include <system_error>
+#include <filesystem>
+#include <cerrno>
+#if __cplusplus >= 202002L
+#include <ranges>
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define SIMPLE_VECTOR_HAS_MMAP 1
+#endif
+#include <string>
+
+// В C++20 std::allocator и std::construct_at работают в константных выражениях,
+// поэтому ArrayPtr и SimpleVector со стандартным распределителем можно заполнять на этапе компиляции
+#ifdef __cpp_lib_constexpr_dynamic_alloc
+#define SIMPLE_VECTOR_CONSTEXPR constexpr
+#else
+#define SIMPLE_VECTOR_CONSTEXPR
+#endif
+
+// Режим проверяемых итераторов SimpleVector. При SIMPLE_VECTOR_CHECKED_ITERATORS == 1 итераторы по умолчанию
+// помнят поколение вектора и проверяют его при разыменовании, иначе итераторы - обычные указатели
+#ifndef SIMPLE_VECTOR_CHECKED_ITERATORS
+#define SIMPLE_VECTOR_CHECKED_ITERATORS 0
+#endif
 
 using namespace std;
 
-template <typename Type>
-class ArrayPtr {
+#define PROFILE_CONCAT_INTERNAL(X, Y) X##Y
+#define PROFILE_CONCAT(X, Y) PROFILE_CONCAT_INTERNAL(X, Y)
+#define UNIQUE_VAR_NAME_PROFILE PROFILE_CONCAT(profileGuard, __LINE__)
+#define LOG_DURATION(x) LogDuration UNIQUE_VAR_NAME_PROFILE(x)
+#define LOG_DURATION_STREAM(x, y) LogDuration UNIQUE_VAR_NAME_PROFILE(x, y)
+
+class LogDuration {
+public:
+    // заменим имя типа std::chrono::steady_clock
+    // с помощью using для удобства
+    using Clock = std::chrono::steady_clock;
+
+    LogDuration(const std::string& id, std::ostream& dst_stream = std::cerr)
+        : id_(id)
+        , dst_stream_(dst_stream) {
+    }
+
+    ~LogDuration() {
+        using namespace std::chrono;
+        using namespace std::literals;
+
+        const auto end_time = Clock::now();
+        const auto dur = end_time - start_time_;
+        dst_stream_ << id_ << ": "s << duration_cast<milliseconds>(dur).count() << " ms"s << std::endl;
+    }
+
+private:
+    const std::string id_;
+    const Clock::time_point start_time_ = Clock::now();
+    std::ostream& dst_stream_;
+};
+
+// Сообщает, вычисляется ли выражение на этапе компиляции.
+// В константных выражениях недоступны memcpy, memmove, memcmp и SIMD, поэтому для них выбираются поэлементные алгоритмы
+constexpr bool IsConstantEvaluated() noexcept {
+#ifdef __cpp_lib_is_constant_evaluated
+    return std::is_constant_evaluated();
+#else
+    return false;
+#endif
+}
+
+// Хранилище распределителя. Пустой распределитель становится базовым классом и благодаря оптимизации
+// пустого базового класса не занимает памяти на любом компиляторе, в том числе на MSVC, который игнорирует [[no_unique_address]]
+template <typename Allocator, bool IsEmpty = std::is_empty_v<Allocator> && !std::is_final_v<Allocator>>
+class AllocatorStorage {
+public:
+    AllocatorStorage() = default;
+
+    SIMPLE_VECTOR_CONSTEXPR explicit AllocatorStorage(const Allocator& alloc) noexcept
+        : alloc_(alloc) {
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR Allocator& GetAllocator() noexcept {
+        return alloc_;
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR const Allocator& GetAllocator() const noexcept {
+        return alloc_;
+    }
+
+private:
+    Allocator alloc_;
+};
+
+template <typename Allocator>
+class AllocatorStorage<Allocator, true> : private Allocator {
+public:
+    AllocatorStorage() = default;
+
+    SIMPLE_VECTOR_CONSTEXPR explicit AllocatorStorage(const Allocator& alloc) noexcept
+        : Allocator(alloc) {
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR Allocator& GetAllocator() noexcept {
+        return *this;
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR const Allocator& GetAllocator() const noexcept {
+        return *this;
+    }
+};
+
+// Режим работы ArrayPtr:
+// при RawMemory == false все size элементов массива конструируются при создании и разрушаются вместе с ним,
+// при RawMemory == true выделяется "сырая" память без конструирования элементов,
+// а конструированием и разрушением элементов управляет владелец ArrayPtr.
+// Память выделяется и освобождается распределителем Allocator (совместимым с std::allocator)
+template <typename Type, bool RawMemory = false, typename Allocator = std::allocator<Type>>
+class ArrayPtr : private AllocatorStorage<Allocator> {
+    using AllocTraits = std::allocator_traits<Allocator>;
+    using Storage = AllocatorStorage<Allocator>;
+    static_assert(std::is_same_v<typename AllocTraits::value_type, Type>, "Allocator::value_type must be Type");
+
 public:
     // Инициализирует ArrayPtr пустым указателем
     ArrayPtr() = default;
 
-    // Создаёт в куче массив из size элементов типа Type.
+    // Инициализирует ArrayPtr пустым указателем с заданным распределителем
+    SIMPLE_VECTOR_CONSTEXPR explicit ArrayPtr(const Allocator& alloc) noexcept
+        : Storage(alloc) {
+    }
+
+    // Создаёт массив из size элементов типа Type в памяти распределителя alloc.
+    // В режиме RawMemory память выделяется без вызова конструкторов элементов.
     // Если size == 0, поле raw_ptr_ должно быть равно nullptr
-    explicit ArrayPtr(size_t size)
-        : raw_ptr_(size != 0 ? new Type[size] : nullptr) {
+    SIMPLE_VECTOR_CONSTEXPR explicit ArrayPtr(size_t size, const Allocator& alloc = Allocator())
+        : Storage(alloc) {
+        raw_ptr_ = Allocate(size);  // может бросить исключение
+        size_ = size;
     }
 
-    // Конструктор из сырого указателя, хранящего адрес массива в куче либо nullptr
-    explicit ArrayPtr(Type* raw_ptr) noexcept
-        : raw_ptr_(raw_ptr) {
+    // Конструктор из сырого указателя на память из size элементов, выделенную распределителем alloc, либо nullptr
+    SIMPLE_VECTOR_CONSTEXPR ArrayPtr(Type* raw_ptr, size_t size, const Allocator& alloc = Allocator()) noexcept
+        : Storage(alloc)
+        , raw_ptr_(raw_ptr)
+        , size_(raw_ptr != nullptr ? size : 0) {
     }
 
     // Запрещаем копирование
     ArrayPtr(const ArrayPtr&) = delete;
 
-    ~ArrayPtr() {
-        delete[] raw_ptr_;
+    // Перемещение передаёт владение памятью вместе с копией распределителя
+    SIMPLE_VECTOR_CONSTEXPR ArrayPtr(ArrayPtr&& other) noexcept
+        : Storage(other.GetAllocator())
+        , raw_ptr_(std::exchange(other.raw_ptr_, nullptr))
+        , size_(std::exchange(other.size_, 0)) {
+    }
+
+    // В режиме RawMemory освобождает только память:
+    // элементы к этому моменту должны быть разрушены владельцем
+    SIMPLE_VECTOR_CONSTEXPR ~ArrayPtr() {
+        Deallocate();
     }
 
     // Запрещаем присваивание
     ArrayPtr& operator=(const ArrayPtr&) = delete;
 
+    // Освобождает свою память и забирает память rhs.
+    // Распределитель передаётся, только если это разрешает propagate_on_container_move_assignment,
+    // иначе распределители обязаны быть равны
+    SIMPLE_VECTOR_CONSTEXPR ArrayPtr& operator=(ArrayPtr&& rhs) noexcept {
+        if (&rhs != this) {
+            Deallocate();
+            if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+                GetAllocator() = std::move(rhs.GetAllocator());
+            }
+            else {
+                assert(GetAllocator() == rhs.GetAllocator());
+            }
+            raw_ptr_ = std::exchange(rhs.raw_ptr_, nullptr);
+            size_ = std::exchange(rhs.size_, 0);
+        }
+        return *this;
+    }
+
+    // Освобождает свою память и заменяет распределитель копией alloc.
+    // Нужен контейнерам, которые передают распределитель при копирующем присваивании
+    SIMPLE_VECTOR_CONSTEXPR void ResetAllocator(const Allocator& alloc) noexcept {
+        Deallocate();
+        GetAllocator() = alloc;
+    }
+
     // Прекращает владением массивом в памяти, возвращает значение адреса массива
     // После вызова метода указатель на массив должен стать обнулиться
-    [[nodiscard]] Type* Release() noexcept {
-        Type* p = raw_ptr_;
-        raw_ptr_ = nullptr;
-        return p;
+    [[nodiscard]] SIMPLE_VECTOR_CONSTEXPR Type* Release() noexcept {
+        size_ = 0;
+        return std::exchange(raw_ptr_, nullptr);
     }
 
     // Возвращает ссылку на элемент массива с индексом index
-    Type& operator[](size_t index) noexcept {
+    SIMPLE_VECTOR_CONSTEXPR Type& operator[](size_t index) noexcept {
         assert(raw_ptr_);
         return raw_ptr_[index];
     }
 
     // Возвращает константную ссылку на элемент массива с индексом index
-    const Type& operator[](size_t index) const noexcept {
+    SIMPLE_VECTOR_CONSTEXPR const Type& operator[](size_t index) const noexcept {
         assert(raw_ptr_);
         return raw_ptr_[index];
     }
 
     // Возвращает true, если указатель ненулевой, и false в противном случае
-    explicit operator bool() const {
+    SIMPLE_VECTOR_CONSTEXPR explicit operator bool() const {
         return raw_ptr_ != nullptr;
     }
 
     // Возвращает значение сырого указателя, хранящего адрес начала массива
-    Type* Get() const noexcept {
+    SIMPLE_VECTOR_CONSTEXPR Type* Get() const noexcept {
         return raw_ptr_;
     }
 
-    // Обменивается значениям указателя на массив с объектом other
-    void swap(ArrayPtr& other) noexcept {
+    // Возвращает количество элементов, под которые выделена память
+    SIMPLE_VECTOR_CONSTEXPR size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    // Возвращает распределитель, которым выделена память
+    using Storage::GetAllocator;
+
+    // Обменивается значениям указателя на массив с объектом other.
+    // Распределители обмениваются, только если это разрешает propagate_on_container_swap,
+    // иначе они обязаны быть равны
+    SIMPLE_VECTOR_CONSTEXPR void swap(ArrayPtr& other) noexcept {
         std::swap(raw_ptr_, other.raw_ptr_);
+        std::swap(size_, other.size_);
+        if constexpr (AllocTraits::propagate_on_container_swap::value) {
+            using std::swap;
+            swap(GetAllocator(), other.GetAllocator());
+        }
+        else {
+            assert(GetAllocator() == other.GetAllocator());
+        }
     }
 
 private:
-    Type* raw_ptr_ = nullptr;
-};
+    SIMPLE_VECTOR_CONSTEXPR Type* Allocate(size_t size) {
+        if (size == 0) {
+            return nullptr;
+        }
+        Type* ptr = AllocTraits::allocate(GetAllocator(), size);  // может бросить исключение
+        if constexpr (!RawMemory) {
+            size_t constructed = 0;
+            try {
+                for (; constructed < size; ++constructed) {
+                    AllocTraits::construct(GetAllocator(), ptr + constructed);  // может бросить исключение
+                }
+            }
+            catch (...) {
+                for (size_t i = 0; i < constructed; ++i) {
+                    AllocTraits::destroy(GetAllocator(), ptr + i);
+                }
+                AllocTraits::deallocate(GetAllocator(), ptr, size);
+                throw;
+            }
+        }
+        return ptr;
+    }
 
-struct ReserveProxyObj {
-    explicit ReserveProxyObj(size_t capacity_to_reserve)
-        : capacity(capacity_to_reserve) {
+    SIMPLE_VECTOR_CONSTEXPR void Deallocate() noexcept {
+        if (raw_ptr_ == nullptr) {
+            return;
+        }
+        if constexpr (!RawMemory) {
+            for (size_t i = 0; i < size_; ++i) {
+                AllocTraits::destroy(GetAllocator(), raw_ptr_ + i);
+            }
+        }
+        AllocTraits::deallocate(GetAllocator(), raw_ptr_, size_);
+        raw_ptr_ = nullptr;
+        size_ = 0;
     }
-    size_t capacity;
+
+    Type* raw_ptr_ = nullptr;
+    size_t size_ = 0;
 };
 
-ReserveProxyObj Reserve(size_t capacity_to_reserve) {
-    return ReserveProxyObj(capacity_to_reserve);
-}
+// Распределитель, выравнивающий каждый выделенный блок по границе Alignment байт
+// (64 - строка кеша и ширина регистра AVX-512)
+template <typename Type, size_t Alignment = 64>
+struct AlignedAllocator {
+    static_assert(Alignment >= alignof(Type) && (Alignment & (Alignment - 1)) == 0,
+        "Alignment must be a power of two not less than alignof(Type)");
 
-template <typename Type>
-class SimpleVector {
-    using ItemsPtr = ArrayPtr<Type>;
+    using value_type = Type;
 
-public:
-    using Iterator = Type*;
-    using ConstIterator = const Type*;
+    template <typename Other>
+    struct rebind {
+        using other = AlignedAllocator<Other, Alignment>;
+    };
 
-    SimpleVector() noexcept = default;
+    AlignedAllocator() noexcept = default;
 
-    // Создаёт вектор из size элементов, инициализированных значением по умолчанию
-    explicit SimpleVector(size_t size)
-        : SimpleVector(size, Type{})  // Делегируем инициализацию конструктору, принимающему size и value
-    {
+    template <typename Other>
+    AlignedAllocator(const AlignedAllocator<Other, Alignment>&) noexcept {
     }
 
-    // Создаёт вектор из size элементов, инициализированных значением value
-    SimpleVector(size_t size, const Type& value)
-        : items_(size)  // может бросить исключение
-        , size_(size)
-        , capacity_(size)  //
-    {
-        std::fill(items_.Get(), items_.Get() + size_, value);  // Может бросить исключение
+    // Наибольшее число элементов, размер которых в байтах не переполняет size_t
+    size_t max_size() const noexcept {
+        return std::numeric_limits<size_t>::max() / sizeof(Type);
     }
 
-    // Создаёт вектор из initializer_list
-    SimpleVector(std::initializer_list<Type> init)
-        : items_(init.size())  // Может бросить исключение
-        , size_(init.size())
-        , capacity_(init.size())  //
-    {
-        std::copy(init.begin(), init.end(), items_.Get());
+    // Выбрасывает std::bad_array_new_length, если n > max_size()
+    Type* allocate(size_t n) {
+        if (n > max_size()) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<Type*>(operator new(n * sizeof(Type), std::align_val_t(Alignment)));  // может бросить исключение
     }
 
-    SimpleVector(ReserveProxyObj reserved)
-        : items_(reserved.capacity)
-        , size_(0)
-        , capacity_(reserved.capacity) {
+    void deallocate(Type* p, size_t) noexcept {
+        operator delete(p, std::align_val_t(Alignment));
     }
 
-    SimpleVector(const SimpleVector& other)
-        : items_(other.size_)  // может бросить исключение
-        , size_(other.size_)
-        , capacity_(other.size_)  //
-    {
-        std::copy(other.items_.Get(), other.items_.Get() + size_, items_.Get());  // может бросить исключение
+    template <typename Other>
+    bool operator==(const AlignedAllocator<Other, Alignment>&) const noexcept {
+        return true;
     }
 
-    SimpleVector& operator=(const SimpleVector& rhs) {
-        if (&rhs != this) {  // оптимизация присваивания вектора самому себе
-            if (rhs.IsEmpty()) {
-                // Оптимизация для случая присваивания пустого вектора
-                Clear();
-            }
-            else {
-                // Применяем идиому Copy-and-swap
-                SimpleVector rhs_copy(rhs);  // может бросить исключение
-                swap(rhs_copy);
-            }
-        }
-        return *this;
+    template <typename Other>
+    bool operator!=(const AlignedAllocator<Other, Alignment>&) const noexcept {
+        return false;
     }
+};
 
-    SimpleVector(SimpleVector&& other) noexcept
-        : items_(other.size_)  // может бросить исключение
-        , size_(other.size_)
-        , capacity_(other.size_)  //
-    {
-        std::copy(std::make_move_iterator(other.items_.Get()), std::make_move_iterator(other.items_.Get() + size_), items_.Get());
-        other.size_ = 0;
-        other.capacity_ = 0;
-    }
+// Размер "огромной" страницы памяти (transparent huge page) на x86-64
+inline constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
 
-    SimpleVector& operator=(SimpleVector&& rhs) noexcept
-    {
-        if (&rhs != this)
-        {
-            if (rhs.IsEmpty()) {
-                // Оптимизация для случая присваивания пустого вектора
-                Clear();
-            }
-            else {
-                size_ = rhs.size_;
-                capacity_ = rhs.capacity_;
-                rhs.size_ = 0;
-                rhs.capacity_ = 0;
-            }
-        }
-        return *this;
-    }
+// Распределитель, размещающий блоки от Threshold байт в отдельных отображениях памяти (mmap),
+// выровненных по границе огромной страницы и помеченных MADV_HUGEPAGE, чтобы ядро отображало их
+// огромными страницами и сканирование больших массивов не упиралось в промахи TLB.
+// Блоки меньше Threshold выделяются как в AlignedAllocator<Type, 64>.
+// На платформах без mmap все блоки выделяются как в AlignedAllocator
+template <typename Type, size_t Threshold = HUGE_PAGE_SIZE>
+struct HugePageAllocator {
+    using value_type = Type;
 
-    // Возвращает количество элементов в массиве
-    size_t GetSize() const noexcept {
-        return size_;
-    }
+    template <typename Other>
+    struct rebind {
+        using other = HugePageAllocator<Other, Threshold>;
+    };
 
-    // Возвращает вместимость массива
-    size_t GetCapacity() const noexcept {
-        return capacity_;
-    }
+    HugePageAllocator() noexcept = default;
 
-    // Сообщает, пустой ли массив
-    bool IsEmpty() const noexcept {
-        return size_ == 0;
+    template <typename Other>
+    HugePageAllocator(const HugePageAllocator<Other, Threshold>&) noexcept {
     }
 
-    // Возвращает ссылку на элемент с индексом index
-    Type& operator[](size_t index) noexcept {
-        assert(index < size_);
-        return items_[index];
+    // Наибольшее число элементов, размер которых в байтах вместе с запасом на выравнивание
+    // по огромной странице не переполняет size_t
+    size_t max_size() const noexcept {
+        return (std::numeric_limits<size_t>::max() - 2 * HUGE_PAGE_SIZE) / sizeof(Type);
     }
 
-    // Возвращает константную ссылку на элемент с индексом index
-    const Type& operator[](size_t index) const noexcept {
-        assert(index < size_);
-        return items_[index];
+    // Выбрасывает std::bad_array_new_length, если n > max_size()
+    Type* allocate(size_t n) {
+        if (n > max_size()) {
+            throw std::bad_array_new_length();
+        }
+        const size_t bytes = n * sizeof(Type);
+#ifdef SIMPLE_VECTOR_HAS_MMAP
+        if (bytes >= Threshold) {
+            return static_cast<Type*>(MapHugePages(bytes));  // может бросить исключение
+        }
+#endif
+        return AlignedAllocator<Type, CACHE_LINE_ALIGNMENT>().allocate(n);  // может бросить исключение
     }
 
-    // Возвращает константную ссылку на элемент с индексом index
-    // Выбрасывает исключение std::out_of_range, если index >= size
-    Type& At(size_t index) {
-        if (index >= size_) {
-            using namespace std;
-            throw out_of_range("Item index is out of range"s);
+    void deallocate(Type* p, size_t n) noexcept {
+        const size_t bytes = n * sizeof(Type);
+#ifdef SIMPLE_VECTOR_HAS_MMAP
+        if (bytes >= Threshold) {
+            munmap(p, RoundUpToHugePage(bytes));
+            return;
         }
-        return items_[index];
+#endif
+        AlignedAllocator<Type, CACHE_LINE_ALIGNMENT>().deallocate(p, n);
     }
 
-    // Возвращает константную ссылку на элемент с индексом index
-    // Выбрасывает исключение std::out_of_range, если index >= size
-    const Type& At(size_t index) const {
-        if (index >= size_) {
-            using namespace std;
-            throw out_of_range("Item index is out of range"s);
-        }
-        return items_[index];
+    template <typename Other>
+    bool operator==(const HugePageAllocator<Other, Threshold>&) const noexcept {
+        return true;
     }
 
-    // Обнуляет размер массива, не изменяя его вместимость
-    void Clear() noexcept {
-        size_ = 0;
+    template <typename Other>
+    bool operator!=(const HugePageAllocator<Other, Threshold>&) const noexcept {
+        return false;
     }
 
-    void Reserve(size_t new_capacity) {
-        if (new_capacity > capacity_) {
-            auto new_items = ReallocateCopy(new_capacity);  // может бросить исключение
+private:
+    static constexpr size_t CACHE_LINE_ALIGNMENT = std::max<size_t>(64, alignof(Type));
 
-            items_.swap(new_items);
-            capacity_ = new_capacity;
+    static size_t RoundUpToHugePage(size_t bytes) noexcept {
+        return (bytes + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+    }
+
+#ifdef SIMPLE_VECTOR_HAS_MMAP
+    // Отображает блок с запасом в одну огромную страницу и обрезает края,
+    // чтобы начало блока было выровнено по границе огромной страницы
+    static void* MapHugePages(size_t bytes) {
+        const size_t size = RoundUpToHugePage(bytes);
+        void* mapped = mmap(nullptr, size + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mapped == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        const uintptr_t address = reinterpret_cast<uintptr_t>(mapped);
+        const uintptr_t aligned = (address + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+        if (aligned != address) {
+            munmap(mapped, aligned - address);
         }
+        const size_t tail = address + size + HUGE_PAGE_SIZE - (aligned + size);
+        if (tail != 0) {
+            munmap(reinterpret_cast<void*>(aligned + size), tail);
+        }
+#ifdef MADV_HUGEPAGE
+        madvise(reinterpret_cast<void*>(aligned), size, MADV_HUGEPAGE);  // подсказка ядру, ошибку можно игнорировать
+#endif
+        return reinterpret_cast<void*>(aligned);
     }
+#endif
+};
 
-    // Изменяет размер массива.
-    // При увеличении размера новые элементы получают значение по умолчанию для типа Type
-    void Resize(size_t new_size) {
-        if (new_size > capacity_) {
-            // Вычисляем вместимость вектора
-            const size_t new_capacity = std::max(capacity_ * 2, new_size);
+// Признак "тривиально перемещаемого" типа: перенос объекта на новое место
+// эквивалентен побайтовому копированию с последующим "забыванием" исходного объекта без вызова деструктора.
+// Для тривиально копируемых типов выполняется автоматически. Пользовательский тип
+// подключается явной специализацией:
+// template <> struct IsTriviallyRelocatable<MyType> : std::true_type {};
+template <typename Type>
+struct IsTriviallyRelocatable : std::is_trivially_copyable<Type> {
+};
 
-            // Копируем существующие элементы вектора на новое местое
-            auto new_items = ReallocateCopy(new_capacity);  // может бросить исключение
-            // заполняем добавленные элементы значением по умолчанию
-            std::fill(new_items.Get() + size_, new_items.Get() + new_size, std::move(Type{}));  // может бросить исключение
+template <typename Type, typename Deleter>
+struct IsTriviallyRelocatable<std::unique_ptr<Type, Deleter>> : std::is_trivially_copyable<Deleter> {
+};
 
-            items_.swap(new_items);
-            capacity_ = new_capacity;
-        }
-        else if (new_size > size_) {
-            assert(new_size <= capacity_);
-            std::fill(items_.Get() + size_, items_.Get() + new_size, Type{});  // может бросить исключение
+template <typename Type>
+inline constexpr bool IsTriviallyRelocatableV = IsTriviallyRelocatable<Type>::value;
+
+// Для std::allocator конструирование через allocator_traits эквивалентно placement new,
+// поэтому можно пользоваться оптимизированными алгоритмами стандартной библиотеки
+template <typename Allocator>
+inline constexpr bool IsStdAllocatorV = std::is_same_v<Allocator, std::allocator<typename Allocator::value_type>>;
+
+// Разрушает элементы [first, last) через распределитель alloc
+template <typename Allocator, typename Type>
+SIMPLE_VECTOR_CONSTEXPR void DestroyRange(Allocator& alloc, Type* first, Type* last) noexcept {
+    if constexpr (IsStdAllocatorV<Allocator>) {
+        std::destroy(first, last);
+    }
+    else {
+        for (; first != last; ++first) {
+            std::allocator_traits<Allocator>::destroy(alloc, first);
         }
-        size_ = new_size;
     }
+}
 
-    // Добавляет элемент в конец вектора
-    // При нехватке места увеличивает вдвое вместимость вектора
-    void PushBack(Type item) {
-        const size_t new_size = size_ + 1;
-        if (new_size > capacity_) {
-            const size_t new_capacity = std::max(capacity_ * 2, new_size);
+// Конструирует count элементов из args в неинициализированной памяти dst через распределитель alloc.
+// Без args элементы инициализируются значением по умолчанию.
+// При исключении уже созданные элементы разрушаются
+template <typename Allocator, typename Type, typename... Args>
+SIMPLE_VECTOR_CONSTEXPR void UninitializedConstructN(Allocator& alloc, Type* dst, size_t count, const Args&... args) {
+    static_assert(sizeof...(Args) <= 1);
+    if constexpr (IsStdAllocatorV<Allocator>) {
+        if (!IsConstantEvaluated()) {
+            if constexpr (sizeof...(Args) == 0) {
+                std::uninitialized_value_construct_n(dst, count);  // может бросить исключение
+            }
+            else {
+                std::uninitialized_fill_n(dst, count, args...);  // может бросить исключение
+            }
+            return;
+        }
+    }
+    Type* current = dst;
+    try {
+        for (; count != 0; --count, ++current) {
+            std::allocator_traits<Allocator>::construct(alloc, current, args...);  // может бросить исключение
+        }
+    }
+    catch (...) {
+        DestroyRange(alloc, dst, current);
+        throw;
+    }
+}
 
-            auto new_items = ReallocateCopy(new_capacity);  // может бросить исключение
-            new_items.Get()[size_] = std::move(item);                  // может бросить исключение
+// Параметры параллельного конструирования элементов.
+// Диапазон делится на thread_count непрерывных частей, каждую из которых конструирует задача общего пула потоков,
+// поэтому страницы памяти впервые затрагиваются рабочими потоками, а не одним вызывающим (first touch).
+// Диапазоны короче threshold элементов конструируются последовательно
+struct ParallelInit {
+    size_t thread_count = std::max(1u, std::thread::hardware_concurrency());
+    size_t threshold = 1 << 20;
+};
 
-            capacity_ = new_capacity;
-            items_.swap(new_items);
+// Пул рабочих потоков для параллельного конструирования элементов.
+// Потоки создаются один раз и переиспользуются всеми вызовами, а не запускаются заново для каждого вектора
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t thread_count) {
+        workers_.reserve(thread_count);  // может бросить исключение
+        try {
+            for (size_t i = 0; i < thread_count; ++i) {
+                workers_.emplace_back([this] {
+                    WorkerLoop();
+                });  // может бросить исключение
+            }
         }
-        else {
-            items_.Get()[size_] = std::move(item);
+        catch (...) {
+            Stop();
+            throw;
         }
-        size_ = new_size;
     }
 
-    // Вставляет значение value в позицию pos.
-    // Возвращает итератор на вставленное значение
-    // Если перед вставкой значения вектор был заполнен полностью,
-    // вместимость вектора должна увеличиться вдвое, а для вектора вместимостью 0 стать равной 1
-    Iterator Insert(Iterator pos, Type value) {
-        assert(begin() <= pos && pos <= end());
-        size_t new_size = size_ + 1;
-        size_t new_item_offset = pos - cbegin();
-        if (new_size <= capacity_) {  // Вместимость вектора достаточна для вставки элемента
-            Iterator mutable_pos = begin() + new_item_offset;
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Выполняет оставшиеся задачи и останавливает потоки
+    ~ThreadPool() {
+        Stop();
+    }
 
-            // Копируем элементы, начиная с последнего, чтобы перенести "хвост" вправо
-            std::copy_backward(std::make_move_iterator(pos), std::make_move_iterator(end()),
-                end() + 1);  // может выбросить исключение
-            *mutable_pos = std::move(value);           // может выбросить исключение
+    // Общий пул из hardware_concurrency потоков, создаваемый при первом обращении
+    static ThreadPool& Shared() {
+        static ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()));
+        return pool;
+    }
 
+    // Ставит задачу в очередь и возвращает future, через который передаётся её исключение
+    template <typename Func>
+    std::future<void> Submit(Func func) {
+        std::packaged_task<void()> task(std::move(func));  // может бросить исключение
+        std::future<void> result = task.get_future();
+        {
+            std::lock_guard guard(mutex_);
+            tasks_.push(std::move(task));  // может бросить исключение
         }
-        else {  // Требуется перевыделить память
-            size_t new_capacity = std::max(capacity_ * 2, new_size);
+        has_tasks_.notify_one();
+        return result;
+    }
 
-            ItemsPtr new_items(new_capacity);  // может выбросить исключение
-            Iterator new_items_pos = new_items.Get() + new_item_offset;
+    // Дожидается результата. Рабочий поток пула тем временем выполняет задачи из очереди,
+    // поэтому ожидание внутри задачи не занимает поток пула впустую и не приводит к взаимной блокировке.
+    // Остальные потоки просто ждут: задачи выполняют только рабочие потоки, и страницы памяти,
+    // которые заполняют задачи ParallelUninitializedConstructN, впервые затрагиваются ими (first touch)
+    void Wait(const std::future<void>& result) {
+        if (!IsWorkerThread()) {
+            result.wait();
+            return;
+        }
+        while (result.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            // Очередь пуста: задача уже выполняется другим потоком
+            if (!RunPendingTask()) {
+                result.wait();
+            }
+        }
+    }
 
-            // Копируем элементы, предшествующие вставляемому
-            std::copy(std::make_move_iterator(begin()), std::make_move_iterator(pos),
-                new_items.Get());  // может выбросить исключение
-// Вставляем элемент в позицию вставки
-            *new_items_pos = std::move(value);  // может выбросить исключение
-            // Копируем элементы следующие за вставляемым
-            std::copy(std::make_move_iterator(pos), std::make_move_iterator(end()),
-                new_items_pos + 1);  // может выбросить исключение
+private:
+    // Сообщает, является ли текущий поток рабочим потоком какого-либо пула
+    static bool& IsWorkerThread() noexcept {
+        thread_local bool is_worker = false;
+        return is_worker;
+    }
 
-            items_.swap(new_items);
-            capacity_ = new_capacity;
+    // Выполняет одну задачу из очереди. Возвращает false, если очередь пуста
+    bool RunPendingTask() {
+        std::packaged_task<void()> task;
+        {
+            std::lock_guard guard(mutex_);
+            if (tasks_.empty()) {
+                return false;
+            }
+            task = std::move(tasks_.front());
+            tasks_.pop();
         }
-        size_ = new_size;
-        return begin() + new_item_offset;
+        task();
+        return true;
     }
 
-    // "Удаляет" элемент с конца вектора, не уменьшая его вместимость
-    void PopBack() noexcept {
-        assert(!IsEmpty());
-        --size_;
+    void WorkerLoop() {
+        IsWorkerThread() = true;
+        for (;;) {
+            std::packaged_task<void()> task;
+            {
+                std::unique_lock lock(mutex_);
+                has_tasks_.wait(lock, [this] {
+                    return stopping_ || !tasks_.empty();
+                });
+                if (tasks_.empty()) {
+                    return;
+                }
+                task = std::move(tasks_.front());
+                tasks_.pop();
+            }
+            task();
+        }
     }
 
-    // Удаляет элемент вектора в позиции pos, сдвигая следующие элементы на его место.
-    // Итератор pos должен быть итератором, ссылающимся на существующий элемент вектора.
-    // Возвращает итератор на элемент, который следует за последним удалённым элементом.
-    // Если был удалён последний элемент, должен вернуться итератор end().
-    Iterator Erase(Iterator pos) {
-        assert(begin() <= pos && pos < end());
-        Iterator mutable_pos = begin() + (pos - begin());
+    void Stop() noexcept {
+        {
+            std::lock_guard guard(mutex_);
+            stopping_ = true;
+        }
+        has_tasks_.notify_all();
+        for (std::thread& worker : workers_) {
+            worker.join();
+        }
+    }
 
-        // Переносим "хвост" влево на места удаляемого элемента
-        std::copy(std::make_move_iterator(mutable_pos + 1), std::make_move_iterator(end()),
-            mutable_pos);  // может выбросить исключение
+    std::vector<std::thread> workers_;
+    std::queue<std::packaged_task<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable has_tasks_;
+    bool stopping_ = false;
+};
 
-        --size_;
-        return mutable_pos;
+// Параллельная версия UninitializedConstructN: части диапазона конструируются задачами общего пула потоков.
+// Если хотя бы одна часть бросила исключение или задачу не удалось запустить,
+// все созданные элементы разрушаются и исключение пробрасывается дальше.
+// Потоки обращаются к распределителю одновременно, поэтому параллельно конструируются только элементы
+// в памяти std::allocator; для распределителей с состоянием (например, pmr) конструирование остаётся последовательным
+template <typename Allocator, typename Type, typename... Args>
+void ParallelUninitializedConstructN(Allocator& alloc, Type* dst, size_t count, ParallelInit parallel, const Args&... args) {
+    const size_t thread_count = std::min(parallel.thread_count, count);
+    if (!IsStdAllocatorV<Allocator> || count < parallel.threshold || thread_count <= 1) {
+        UninitializedConstructN(alloc, dst, count, args...);  // может бросить исключение
+        return;
     }
 
-    // Обменивает значение с другим вектором
-    void swap(SimpleVector& other) noexcept {
-        items_.swap(other.items_);
-        std::swap(size_, other.size_);
-        std::swap(capacity_, other.capacity_);
+    const size_t chunk_size = (count + thread_count - 1) / thread_count;
+    const size_t chunk_count = (count + chunk_size - 1) / chunk_size;
+    // Память для учёта частей выделяется до запуска задач: после запуска ожидание не должно прерываться исключением,
+    // пока задачи обращаются к аргументам этой функции
+    std::vector<std::future<void>> futures;
+    futures.reserve(chunk_count);  // может бросить исключение
+    std::vector<bool> constructed(chunk_count, false);  // может бросить исключение
+
+    ThreadPool& pool = ThreadPool::Shared();
+    std::exception_ptr error;
+    try {
+        for (size_t begin = 0; begin < count; begin += chunk_size) {
+            const size_t chunk = std::min(chunk_size, count - begin);
+            futures.push_back(pool.Submit([&alloc, dst, begin, chunk, &args...] {
+                UninitializedConstructN(alloc, dst + begin, chunk, args...);  // может бросить исключение
+            }));  // может бросить исключение
+        }
+    }
+    catch (...) {
+        // Запущенные части дожидаются и разрушаются вместе с остальными ниже
+        error = std::current_exception();
     }
 
-    // Возвращает итератор на начало массива
-    // Для пустого массива может быть равен (или не равен) nullptr
-    Iterator begin() noexcept {
-        return items_.Get();
-    }
-
-    // Возвращает итератор на элемент, следующий за последним
-    // Для пустого массива может быть равен (или не равен) nullptr
-    Iterator end() noexcept {
-        return items_.Get() + size_;
+    // Дожидаемся всех запущенных частей, запоминая первое исключение.
+    // При ошибке части, сконструированные успешно, разрушаются
+    for (const std::future<void>& result : futures) {
+        pool.Wait(result);
     }
-
-    // Возвращает константный итератор на начало массива
-    // Для пустого массива может быть равен (или не равен) nullptr
-    ConstIterator begin() const noexcept {
-        return items_.Get();
+    for (size_t i = 0; i < futures.size(); ++i) {
+        try {
+            futures[i].get();
+            constructed[i] = true;
+        }
+        catch (...) {
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
     }
-
-    // Возвращает итератор на элемент, следующий за последним
-    // Для пустого массива может быть равен (или не равен) nullptr
-    ConstIterator end() const noexcept {
-        return items_.Get() + size_;
+    if (error) {
+        for (size_t i = 0; i < futures.size(); ++i) {
+            if (constructed[i]) {
+                Type* chunk_begin = dst + i * chunk_size;
+                DestroyRange(alloc, chunk_begin, chunk_begin + std::min(chunk_size, count - i * chunk_size));
+            }
+        }
+        std::rethrow_exception(error);
     }
+}
 
-    // Возвращает константный итератор на начало массива
-    // Для пустого массива может быть равен (или не равен) nullptr
-    ConstIterator cbegin() const noexcept {
-        return items_.Get();
+// Копирует элементы [first, last) в неинициализированную память dst через распределитель alloc.
+// Возвращает указатель на ячейку, следующую за последним созданным элементом.
+// При исключении уже созданные элементы разрушаются
+template <typename Allocator, typename InputIt, typename Type>
+SIMPLE_VECTOR_CONSTEXPR Type* UninitializedCopy(Allocator& alloc, InputIt first, InputIt last, Type* dst) {
+    if constexpr (IsStdAllocatorV<Allocator>) {
+        if (!IsConstantEvaluated()) {
+            return std::uninitialized_copy(first, last, dst);  // может бросить исключение
+        }
     }
-
-    // Возвращает итератор на элемент, следующий за последним
-    // Для пустого массива может быть равен (или не равен) nullptr
-    ConstIterator cend() const noexcept {
-        return items_.Get() + size_;
+    Type* current = dst;
+    try {
+        for (; first != last; ++first, ++current) {
+            std::allocator_traits<Allocator>::construct(alloc, current, *first);  // может бросить исключение
+        }
     }
-
-private:
-    // Выделяет копию текущего массива с заданной вместимостью
-    ItemsPtr ReallocateCopy(size_t new_capacity) const {
-        ItemsPtr new_items(new_capacity);  // может бросить исключение
-        size_t copy_size = std::min(new_capacity, size_);
-        std::copy(std::make_move_iterator(items_.Get()), std::make_move_iterator(items_.Get() + copy_size),
-            new_items.Get());  // может бросить исключение
-        return ItemsPtr(new_items.Release());
+    catch (...) {
+        DestroyRange(alloc, dst, current);
+        throw;
     }
+    return current;
+}
 
-    ItemsPtr items_;
-    size_t size_ = 0;
-    size_t capacity_ = 0;
-};
+// Перемещает элементы [first, last) в неинициализированную память dst через распределитель alloc
+template <typename Allocator, typename Type>
+SIMPLE_VECTOR_CONSTEXPR Type* UninitializedMove(Allocator& alloc, Type* first, Type* last, Type* dst) {
+    return UninitializedCopy(alloc, std::make_move_iterator(first), std::make_move_iterator(last), dst);  // может бросить исключение
+}
 
+// При переносе элементов в новую память перемещение используется, только если оно не бросает исключений
+// (или копирование невозможно), иначе элементы копируются, и при исключении исходные элементы остаются нетронутыми
 template <typename Type>
-inline bool operator==(const SimpleVector<Type>& lhs, const SimpleVector<Type>& rhs) {
-    return (lhs.GetSize() == rhs.GetSize())
-        && std::equal(lhs.begin(), lhs.end(), rhs.begin());  // может бросить исключение
+inline constexpr bool MoveOnRelocateV = std::is_nothrow_move_constructible_v<Type> || !std::is_copy_constructible_v<Type>;
+
+// Перемещает (по правилам move_if_noexcept) или копирует элементы [first, last) в неинициализированную память dst
+template <typename Allocator, typename Type>
+SIMPLE_VECTOR_CONSTEXPR Type* UninitializedMoveIfNoexcept(Allocator& alloc, Type* first, Type* last, Type* dst) {
+    if constexpr (MoveOnRelocateV<Type>) {
+        return UninitializedMove(alloc, first, last, dst);  // может бросить исключение
+    }
+    else {
+        return UninitializedCopy(alloc, static_cast<const Type*>(first), static_cast<const Type*>(last), dst);  // может бросить исключение
+    }
 }
 
+// Поэлементно переносит count тривиально копируемых элементов из src в dst в константном выражении,
+// где memcpy и memmove недоступны. Перекрывающиеся диапазоны при сдвиге вправо копируются с конца (backward)
 template <typename Type>
-inline bool operator!=(const SimpleVector<Type>& lhs, const SimpleVector<Type>& rhs) {
-    return !(lhs == rhs);  // может бросить исключение
+constexpr void ConstexprShift(Type* dst, const Type* src, size_t count, bool backward) noexcept {
+#ifdef __cpp_lib_constexpr_dynamic_alloc
+    if (!backward) {
+        for (size_t i = 0; i < count; ++i) {
+            std::construct_at(dst + i, src[i]);
+        }
+    }
+    else {
+        for (size_t i = count; i > 0; --i) {
+            std::construct_at(dst + i - 1, src[i - 1]);
+        }
+    }
+#else
+    (void)dst, (void)src, (void)count, (void)backward;
+#endif
 }
 
+// Побайтово переносит тривиально перемещаемые элементы [first, last) в неинициализированную память dst.
+// Исходные элементы считаются перенесёнными и не разрушаются
 template <typename Type>
-inline bool operator<(const SimpleVector<Type>& lhs, const SimpleVector<Type>& rhs) {
-    return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());  // может бросить исключение
+SIMPLE_VECTOR_CONSTEXPR void RelocateBytes(const Type* first, const Type* last, Type* dst) noexcept {
+    static_assert(IsTriviallyRelocatableV<Type>);
+    if constexpr (std::is_trivially_copyable_v<Type>) {
+        if (IsConstantEvaluated()) {
+            ConstexprShift(dst, first, last - first, false);
+            return;
+        }
+    }
+    if (first != last) {
+        std::memcpy(static_cast<void*>(dst), first, (last - first) * sizeof(Type));
+    }
 }
 
+// Сдвигает count тривиально перемещаемых элементов из src в dst одним memmove, диапазоны могут перекрываться
 template <typename Type>
-inline bool operator<=(const SimpleVector<Type>& lhs, const SimpleVector<Type>& rhs) {
-    return !(rhs < lhs);  // может бросить исключение
+SIMPLE_VECTOR_CONSTEXPR void ShiftBytes(Type* dst, const Type* src, size_t count) noexcept {
+    static_assert(IsTriviallyRelocatableV<Type>);
+    if constexpr (std::is_trivially_copyable_v<Type>) {
+        if (IsConstantEvaluated()) {
+            ConstexprShift(dst, src, count, src < dst);
+            return;
+        }
+    }
+    if (count != 0) {
+        std::memmove(static_cast<void*>(dst), src, count * sizeof(Type));
+    }
 }
 
-template <typename Type>
-inline bool operator>(const SimpleVector<Type>& lhs, const SimpleVector<Type>& rhs) {
-    return rhs < lhs;  // может бросить исключение
+// Переносит элементы [first, last) в неинициализированную память dst и разрушает исходные элементы.
+// Если перенос бросил исключение, исходные элементы не изменены
+template <typename Allocator, typename Type>
+SIMPLE_VECTOR_CONSTEXPR void UninitializedRelocate(Allocator& alloc, Type* first, Type* last, Type* dst) {
+    if constexpr (IsTriviallyRelocatableV<Type>) {
+        RelocateBytes<Type>(first, last, dst);
+    }
+    else {
+        UninitializedMoveIfNoexcept(alloc, first, last, dst);  // может бросить исключение
+        DestroyRange(alloc, first, last);
+    }
 }
 
 template <typename Type>
-inline bool operator>=(const SimpleVector<Type>& lhs, const SimpleVector<Type>& rhs) {
-    return rhs <= lhs;  // может бросить исключение
+SIMPLE_VECTOR_CONSTEXPR void UninitializedRelocate(Type* first, Type* last, Type* dst) {
+    std::allocator<Type> alloc;
+    UninitializedRelocate(alloc, first, last, dst);  // может бросить исключение
 }
 
-class X {
-public:
-    X()
-        : X(5) {
-    }
-    X(size_t num)
-        : x_(num) {
-    }
-    X(const X& other) = delete;
-    X& operator=(const X& other) = delete;
-    X(X&& other) {
-        x_ = exchange(other.x_, 0);
-    }
-    X& operator=(X&& other) {
-        x_ = exchange(other.x_, 0);
-        return *this;
+// Политики роста вместимости вектора.
+// Метод NextCapacity(capacity) возвращает желаемую вместимость после заполнения вектора вместимостью capacity;
+// если её недостаточно для требуемого размера, вектор выделяет ровно требуемое количество элементов
+
+// Рост вдвое: наименьшее число перевыделений при добавлении в конец
+struct DoublingGrowth {
+    static constexpr size_t NextCapacity(size_t capacity) noexcept {
+        return capacity * 2;
     }
-    size_t GetX() const {
-        return x_;
+};
+
+// Рост в 1.5 раза: сумма ранее освобождённых блоков со временем превышает новый запрос,
+// и распределитель может повторно использовать освобождённую память
+struct OneAndHalfGrowth {
+    static constexpr size_t NextCapacity(size_t capacity) noexcept {
+        return capacity + capacity / 2;
     }
+};
 
-private:
-    size_t x_;
+// Геометрический рост вдвое, ограниченный шагом не более MaxStep элементов за одно перевыделение
+template <size_t MaxStep>
+struct ClampedGrowth {
+    static_assert(MaxStep > 0);
+    static constexpr size_t NextCapacity(size_t capacity) noexcept {
+        return capacity + std::min(capacity, MaxStep);
+    }
 };
 
-SimpleVector<int> GenerateVector(size_t size) {
-    SimpleVector<int> v(size);
-    iota(v.begin(), v.end(), 1);
-    return v;
-}
+// Заголовок двоичного формата вектора. За ним следуют count элементов по element_size байт.
+// Числа записываются в порядке байтов платформы
+struct BinaryHeader {
+    static constexpr char MAGIC[4] = { 'S', 'V', 'B', '1' };
 
-void TestTemporaryObjConstructor() {
-    const size_t size = 1000000;
-    cout << "Test with temporary object, copy elision" << endl;
-    SimpleVector<int> moved_vector(GenerateVector(size));
-    assert(moved_vector.GetSize() == size);
-    cout << "Done!" << endl << endl;
-}
+    char magic[4] = { MAGIC[0], MAGIC[1], MAGIC[2], MAGIC[3] };
+    uint32_t element_size = 0;
+    uint64_t count = 0;
+    uint64_t checksum = 0;
+    uint64_t reserved = 0;
+};
+static_assert(sizeof(BinaryHeader) == 32);
 
-void TestTemporaryObjOperator() {
-    const size_t size = 1000000;
-    cout << "Test with temporary object, operator=" << endl;
-    SimpleVector<int> moved_vector;
-    assert(moved_vector.GetSize() == 0);
-    moved_vector = GenerateVector(size);
-    assert(moved_vector.GetSize() == size);
-    cout << "Done!" << endl << endl;
+// Быстрая некриптографическая контрольная сумма: обрабатывает данные словами по 8 байт
+inline uint64_t ComputeChecksum(const void* data, size_t size) noexcept {
+    constexpr uint64_t PRIME = 0x9E3779B97F4A7C15ull;
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    uint64_t hash = size * PRIME;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, bytes + i, 8);
+        hash = (hash ^ word) * PRIME;
+        hash ^= hash >> 29;
+    }
+    uint64_t tail = 0;
+    if (i < size) {
+        std::memcpy(&tail, bytes + i, size - i);
+    }
+    hash = (hash ^ tail) * PRIME;
+    return hash ^ (hash >> 32);
 }
 
-void TestNamedMoveConstructor() {
-    const size_t size = 1000000;
-    cout << "Test with named object, move constructor" << endl;
-    SimpleVector<int> vector_to_move(GenerateVector(size));
-    assert(vector_to_move.GetSize() == size);
+// Проверяет заголовок двоичного формата для элементов размера element_size.
+// Выбрасывает std::runtime_error, если формат не совпадает
+inline void CheckBinaryHeader(const BinaryHeader& header, size_t element_size) {
+    if (std::memcmp(header.magic, BinaryHeader::MAGIC, sizeof(header.magic)) != 0) {
+        throw std::runtime_error("Not a SimpleVector binary stream"s);
+    }
+    if (header.element_size != element_size) {
+        throw std::runtime_error("Binary stream element size mismatch"s);
+    }
+}
 
-    SimpleVector<int> moved_vector(move(vector_to_move));
-    assert(moved_vector.GetSize() == size);
-    assert(vector_to_move.GetSize() == 0);
-    cout << "Done!" << endl << endl;
+// Возвращает число байт от текущей позиции до конца потока или -1, если поток не поддерживает позиционирование
+inline std::streamoff RemainingStreamSize(std::istream& input) {
+    const std::istream::pos_type position = input.tellg();
+    if (position == std::istream::pos_type(-1)) {
+        return -1;
+    }
+    const std::istream::pos_type end = input.seekg(0, std::ios::end).tellg();
+    input.clear();
+    input.seekg(position);
+    return end == std::istream::pos_type(-1) ? -1 : end - position;
 }
 
-void TestNamedMoveOperator() {
-    const size_t size = 1000000;
-    cout << "Test with named object, operator=" << endl;
-    SimpleVector<int> vector_to_move(GenerateVector(size));
-    assert(vector_to_move.GetSize() == size);
+// Непрерывный диапазон элементов, не владеющий памятью
+template <typename Type>
+class Span {
+public:
+    using Iterator = Type*;
 
-    SimpleVector<int> moved_vector = move(vector_to_move);
-    assert(moved_vector.GetSize() == size);
-    assert(vector_to_move.GetSize() == 0);
-    cout << "Done!" << endl << endl;
-}
+    Span() noexcept = default;
 
-void TestNoncopiableMoveConstructor() {
-    const size_t size = 5;
-    cout << "Test noncopiable object, move constructor" << endl;
-    SimpleVector<X> vector_to_move;
-    for (size_t i = 0; i < size; ++i) {
-        vector_to_move.PushBack(X(i));
+    Span(Type* data, size_t size) noexcept
+        : data_(data)
+        , size_(size) {
     }
 
-    SimpleVector<X> moved_vector = move(vector_to_move);
-    assert(moved_vector.GetSize() == size);
-    assert(vector_to_move.GetSize() == 0);
+    size_t GetSize() const noexcept {
+        return size_;
+    }
 
-    for (size_t i = 0; i < size; ++i) {
-        assert(moved_vector[i].GetX() == i);
+    bool IsEmpty() const noexcept {
+        return size_ == 0;
     }
-    cout << "Done!" << endl << endl;
-}
 
-void TestNoncopiablePushBack() {
-    const size_t size = 5;
-    cout << "Test noncopiable push back" << endl;
-    SimpleVector<X> v;
-    for (size_t i = 0; i < size; ++i) {
-        v.PushBack(X(i));
+    Type* Data() const noexcept {
+        return data_;
     }
 
-    assert(v.GetSize() == size);
+    Type& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return data_[index];
+    }
 
-    for (size_t i = 0; i < size; ++i) {
-        assert(v[i].GetX() == i);
+    Iterator begin() const noexcept {
+        return data_;
     }
-    cout << "Done!" << endl << endl;
-}
 
-void TestNoncopiableInsert() {
-    const size_t size = 5;
-    cout << "Test noncopiable insert" << endl;
-    SimpleVector<X> v;
-    for (size_t i = 0; i < size; ++i) {
-        v.PushBack(X(i));
+    Iterator end() const noexcept {
+        return data_ + size_;
     }
 
-    // в начало
-    v.Insert(v.begin(), X(size + 1));
-    assert(v.GetSize() == size + 1);
-    assert(v.begin()->GetX() == size + 1);
-    // в конец
-    v.Insert(v.end(), X(size + 2));
-    assert(v.GetSize() == size + 2);
-    assert((v.end() - 1)->GetX() == size + 2);
-    // в середину
-    v.Insert(v.begin() + 3, X(size + 3));
-    assert(v.GetSize() == size + 3);
-    assert((v.begin() + 3)->GetX() == size + 3);
-    cout << "Done!" << endl << endl;
-}
+private:
+    Type* data_ = nullptr;
+    size_t size_ = 0;
+};
 
-void TestNoncopiableErase() {
-    const size_t size = 3;
-    cout << "Test noncopiable erase" << endl;
-    SimpleVector<X> v;
-    for (size_t i = 0; i < size; ++i) {
-        v.PushBack(X(i));
+struct ReserveProxyObj {
+    explicit ReserveProxyObj(size_t capacity_to_reserve)
+        : capacity(capacity_to_reserve) {
     }
+    size_t capacity;
+};
 
-    auto it = v.Erase(v.begin());
-    assert(it->GetX() == 1);
-    cout << "Done!" << endl << endl;
+ReserveProxyObj Reserve(size_t capacity_to_reserve) {
+    return ReserveProxyObj(capacity_to_reserve);
 }
 
-void TestResizeMethodNoCopy() {
-    cout << "TestResizeMethodNoCopy"s << endl;
-    // создаем пустой вектор элементов с запрещённым копированием
-    SimpleVector<X> v;
+// Поколение вектора для режима проверки итераторов.
+// В обычном режиме SimpleVector наследует пустую специализацию и благодаря оптимизации пустого базового класса
+// не тратит на поколение памяти на любом компиляторе, в том числе на MSVC, который игнорирует [[no_unique_address]]
+template <bool CheckedIterators>
+struct IteratorGeneration {
+    size_t generation_ = 0;
+};
 
-    // поместим 10 элементов в вектор
-    for (int i = 0; i < 10; ++i) {
-        v.PushBack(X(i));
-    }
-    assert(v.GetSize() == 10);
+template <>
+struct IteratorGeneration<false> {
+};
 
-    // увеличиваем размер в два раза
-    v.Resize(20);
+// Вектор хранит элементы в "сырой" памяти, выделенной распределителем Allocator:
+// сконструированы только элементы диапазона [0, size_), ячейки [size_, capacity) не инициализированы.
+// Элементы конструируются через std::allocator_traits<Allocator>::construct,
+// поэтому std::pmr::polymorphic_allocator передаёт свой ресурс памяти элементам
+template <typename Type, typename Allocator = std::allocator<Type>, typename GrowthPolicy = DoublingGrowth,
+    bool CheckedIterators = SIMPLE_VECTOR_CHECKED_ITERATORS != 0>
+class SimpleVector : private IteratorGeneration<CheckedIterators> {
+    using ItemsPtr = ArrayPtr<Type, true, Allocator>;
+    using AllocTraits = std::allocator_traits<Allocator>;
 
-    assert(v.GetSize() == 20);
+    // Итератор режима проверки: помнит вектор и его поколение на момент создания.
+    // Разыменование итератора, выданного до перевыделения памяти или сдвига элементов,
+    // выбрасывает std::logic_error, а выход за границы [begin(), end()) - std::out_of_range
+    template <typename Value>
+    class CheckedIterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = Type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = Value*;
+        using reference = Value&;
 
-    // проверяем, что первые 10 элементов не изменились
-    for (size_t i = 0; i < 10; ++i) {
-        assert(v[i].GetX() == i);
-    }
+        SIMPLE_VECTOR_CONSTEXPR CheckedIterator() noexcept = default;
 
-    // проверяем, что следующие 10 элементов заполнились значением по-умолчанию
-    for (size_t i = 10; i < 20; ++i) {
-        assert(v[i].GetX() == 5);
-    }
+        // Неконстантный итератор неявно преобразуется в константный
+        template <typename Other, typename = std::enable_if_t<std::is_same_v<Value, const Other>>>
+        SIMPLE_VECTOR_CONSTEXPR CheckedIterator(const CheckedIterator<Other>& other) noexcept
+            : owner_(other.owner_)
+            , ptr_(other.ptr_)
+            , generation_(other.generation_) {
+        }
 
-    // уменьшаем размер в 4 раза
-    v.Resize(5);
+        SIMPLE_VECTOR_CONSTEXPR reference operator*() const {
+            return *CheckedPtr(ptr_);
+        }
 
-    assert(v.GetSize() == 5);
+        SIMPLE_VECTOR_CONSTEXPR pointer operator->() const {
+            return CheckedPtr(ptr_);
+        }
 
-    // проверяем, что первые 5 элементов не изменились
-    for (size_t i = 0; i < 5; ++i) {
-        assert(v[i].GetX() == i);
-    }
+        SIMPLE_VECTOR_CONSTEXPR reference operator[](difference_type offset) const {
+            return *CheckedPtr(ptr_ + offset);
+        }
 
-    // увеличиваем размер в два раза
-    v.Resize(10);
+        SIMPLE_VECTOR_CONSTEXPR CheckedIterator& operator++() noexcept {
+            ++ptr_;
+            return *this;
+        }
 
-    assert(v.GetSize() == 10);
+        SIMPLE_VECTOR_CONSTEXPR CheckedIterator operator++(int) noexcept {
+            CheckedIterator old(*this);
+            ++ptr_;
+            return old;
+        }
 
-    // проверяем, что первые 5 элементов не изменились
-    for (size_t i = 0; i < 5; ++i) {
-        assert(v[i].GetX() == i);
-    }
+        SIMPLE_VECTOR_CONSTEXPR CheckedIterator& operator--() noexcept {
+            --ptr_;
+            return *this;
+        }
 
-    // проверяем, что следующие 5 элементов заполнились значением по-умолчанию
-    for (size_t i = 5; i < 10; ++i) {
-        assert(v[i].GetX() == 5);
+        SIMPLE_VECTOR_CONSTEXPR CheckedIterator operator--(int) noexcept {
+            CheckedIterator old(*this);
+            --ptr_;
+            return old;
+        }
+
+        SIMPLE_VECTOR_CONSTEXPR CheckedIterator& operator+=(difference_type offset) noexcept {
+            ptr_ += offset;
+            return *this;
+        }
+
+        SIMPLE_VECTOR_CONSTEXPR CheckedIterator& operator-=(difference_type offset) noexcept {
+            ptr_ -= offset;
+            return *this;
+        }
+
+        friend SIMPLE_VECTOR_CONSTEXPR CheckedIterator operator+(CheckedIterator it, difference_type offset) noexcept {
+            return it += offset;
+        }
+
+        friend SIMPLE_VECTOR_CONSTEXPR CheckedIterator operator+(difference_type offset, CheckedIterator it) noexcept {
+            return it += offset;
+        }
+
+        friend SIMPLE_VECTOR_CONSTEXPR CheckedIterator operator-(CheckedIterator it, difference_type offset) noexcept {
+            return it -= offset;
+        }
+
+        friend SIMPLE_VECTOR_CONSTEXPR difference_type operator-(const CheckedIterator& lhs, const CheckedIterator& rhs) noexcept {
+            return lhs.ptr_ - rhs.ptr_;
+        }
+
+        friend SIMPLE_VECTOR_CONSTEXPR bool operator==(const CheckedIterator& lhs, const CheckedIterator& rhs) noexcept {
+            return lhs.ptr_ == rhs.ptr_;
+        }
+
+        friend SIMPLE_VECTOR_CONSTEXPR bool operator!=(const CheckedIterator& lhs, const CheckedIterator& rhs) noexcept {
+            return lhs.ptr_ != rhs.ptr_;
+        }
+
+        friend SIMPLE_VECTOR_CONSTEXPR bool operator<(const CheckedIterator& lhs, const CheckedIterator& rhs) noexcept {
+            return lhs.ptr_ < rhs.ptr_;
+        }
+
+        friend SIMPLE_VECTOR_CONSTEXPR bool operator<=(const CheckedIterator& lhs, const CheckedIterator& rhs) noexcept {
+            return lhs.ptr_ <= rhs.ptr_;
+        }
+
+        friend SIMPLE_VECTOR_CONSTEXPR bool operator>(const CheckedIterator& lhs, const CheckedIterator& rhs) noexcept {
+            return lhs.ptr_ > rhs.ptr_;
+        }
+
+        friend SIMPLE_VECTOR_CONSTEXPR bool operator>=(const CheckedIterator& lhs, const CheckedIterator& rhs) noexcept {
+            return lhs.ptr_ >= rhs.ptr_;
+        }
+
+    private:
+        friend class SimpleVector;
+        template <typename>
+        friend class CheckedIterator;
+
+        SIMPLE_VECTOR_CONSTEXPR CheckedIterator(const SimpleVector* owner, Value* ptr) noexcept
+            : owner_(owner)
+            , ptr_(ptr)
+            , generation_(owner->generation_) {
+        }
+
+        // Проверяет, что вектор не изменялся с момента создания итератора, и возвращает его позицию
+        SIMPLE_VECTOR_CONSTEXPR Value* Base() const {
+            if (owner_ == nullptr || generation_ != owner_->generation_) {
+                throw logic_error("SimpleVector iterator is invalidated"s);
+            }
+            return ptr_;
+        }
+
+        // Дополнительно проверяет, что ptr указывает на существующий элемент
+        SIMPLE_VECTOR_CONSTEXPR Value* CheckedPtr(Value* ptr) const {
+            Base();
+            if (ptr < owner_->Data() || ptr >= owner_->DataEnd()) {
+                throw out_of_range("SimpleVector iterator is out of range"s);
+            }
+            return ptr;
+        }
+
+        const SimpleVector* owner_ = nullptr;
+        Value* ptr_ = nullptr;
+        size_t generation_ = 0;
+    };
+
+public:
+    using Iterator = std::conditional_t<CheckedIterators, CheckedIterator<Type>, Type*>;
+    using ConstIterator = std::conditional_t<CheckedIterators, CheckedIterator<const Type>, const Type*>;
+    using AllocatorType = Allocator;
+
+    SimpleVector() noexcept(noexcept(Allocator())) = default;
+
+    // Создаёт пустой вектор, память которого будет выделяться распределителем alloc
+    SIMPLE_VECTOR_CONSTEXPR explicit SimpleVector(const Allocator& alloc) noexcept
+        : items_(alloc) {
+    }
+
+    // Создаёт вектор из size элементов, инициализированных значением по умолчанию
+    SIMPLE_VECTOR_CONSTEXPR explicit SimpleVector(size_t size, const Allocator& alloc = Allocator())
+        : items_(size, alloc)  // может бросить исключение
+    {
+        UninitializedConstructN(Alloc(), items_.Get(), size);  // может бросить исключение
+        size_ = size;
+    }
+
+    // Создаёт вектор из size элементов, инициализированных значением value
+    SIMPLE_VECTOR_CONSTEXPR SimpleVector(size_t size, const Type& value, const Allocator& alloc = Allocator())
+        : items_(size, alloc)  // может бросить исключение
+    {
+        UninitializedConstructN(Alloc(), items_.Get(), size, value);  // Может бросить исключение
+        size_ = size;
+    }
+
+    // Создаёт вектор из size элементов, инициализированных значением по умолчанию, параллельно в нескольких потоках
+    SimpleVector(size_t size, ParallelInit parallel, const Allocator& alloc = Allocator())
+        : items_(size, alloc)  // может бросить исключение
+    {
+        ParallelUninitializedConstructN(Alloc(), items_.Get(), size, parallel);  // может бросить исключение
+        size_ = size;
+    }
+
+    // Создаёт вектор из size элементов, инициализированных значением value, параллельно в нескольких потоках
+    SimpleVector(size_t size, const Type& value, ParallelInit parallel, const Allocator& alloc = Allocator())
+        : items_(size, alloc)  // может бросить исключение
+    {
+        ParallelUninitializedConstructN(Alloc(), items_.Get(), size, parallel, value);  // может бросить исключение
+        size_ = size;
+    }
+
+    // Создаёт вектор из initializer_list
+    SIMPLE_VECTOR_CONSTEXPR SimpleVector(std::initializer_list<Type> init, const Allocator& alloc = Allocator())
+        : items_(init.size(), alloc)  // Может бросить исключение
+    {
+        UninitializedCopy(Alloc(), init.begin(), init.end(), items_.Get());  // может бросить исключение
+        size_ = init.size();
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR SimpleVector(ReserveProxyObj reserved, const Allocator& alloc = Allocator())
+        : items_(reserved.capacity, alloc) {
+    }
+
+    // Копия получает распределитель, выбранный select_on_container_copy_construction
+    SIMPLE_VECTOR_CONSTEXPR SimpleVector(const SimpleVector& other)
+        : SimpleVector(other, AllocTraits::select_on_container_copy_construction(other.GetAllocator())) {
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR SimpleVector(const SimpleVector& other, const Allocator& alloc)
+        : items_(other.size_, alloc)  // может бросить исключение
+    {
+        UninitializedCopy(Alloc(), other.Data(), other.DataEnd(), items_.Get());  // может бросить исключение
+        size_ = other.size_;
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR SimpleVector& operator=(const SimpleVector& rhs) {
+        if (&rhs != this) {  // оптимизация присваивания вектора самому себе
+            if constexpr (AllocTraits::propagate_on_container_copy_assignment::value) {
+                if (items_.GetAllocator() != rhs.items_.GetAllocator()) {
+                    // Распределитель передаётся вместе с элементами: копия создаётся в памяти распределителя rhs,
+                    // а прежний буфер освобождается прежним распределителем
+                    SimpleVector rhs_copy(rhs, rhs.items_.GetAllocator());  // может бросить исключение
+                    Clear();
+                    items_.ResetAllocator(rhs.items_.GetAllocator());
+                    swap(rhs_copy);
+                    return *this;
+                }
+            }
+            if (rhs.IsEmpty()) {
+                // Оптимизация для случая присваивания пустого вектора
+                Clear();
+            }
+            else {
+                // Применяем идиому Copy-and-swap, копия создаётся в памяти нашего распределителя
+                SimpleVector rhs_copy(rhs, items_.GetAllocator());  // может бросить исключение
+                swap(rhs_copy);
+            }
+        }
+        return *this;
+    }
+
+    // Забирает буфер other за O(1), other становится пустым вектором без памяти
+    SIMPLE_VECTOR_CONSTEXPR SimpleVector(SimpleVector&& other) noexcept
+        : items_(std::move(other.items_))
+        , size_(std::exchange(other.size_, 0)) {
+        other.Invalidate();
+    }
+
+    // Забирает буфер rhs за O(1), прежние элементы разрушаются.
+    // Если распределитель не передаётся при перемещении и распределители различны,
+    // элементы rhs поштучно перемещаются в память нашего распределителя
+    SIMPLE_VECTOR_CONSTEXPR SimpleVector& operator=(SimpleVector&& rhs) noexcept(
+        AllocTraits::propagate_on_container_move_assignment::value || AllocTraits::is_always_equal::value) {
+        if (&rhs != this) {
+            if (AllocTraits::propagate_on_container_move_assignment::value
+                || items_.GetAllocator() == rhs.items_.GetAllocator()) {
+                Clear();
+                items_ = std::move(rhs.items_);
+                size_ = std::exchange(rhs.size_, 0);
+                Invalidate();
+                rhs.Invalidate();
+            }
+            else {
+                ItemsPtr new_items(rhs.size_, items_.GetAllocator());  // может бросить исключение
+                UninitializedMove(Alloc(), rhs.Data(), rhs.DataEnd(), new_items.Get());  // может бросить исключение
+                Clear();
+                items_.swap(new_items);
+                size_ = rhs.size_;
+                Invalidate();
+                rhs.Clear();
+            }
+        }
+        return *this;
+    }
+
+    // Разрушает живые элементы [0, size_), память освобождает ArrayPtr
+    SIMPLE_VECTOR_CONSTEXPR ~SimpleVector() {
+        DestroyRange(Alloc(), Data(), DataEnd());
+    }
+
+    // Возвращает копию распределителя памяти
+    SIMPLE_VECTOR_CONSTEXPR Allocator GetAllocator() const noexcept {
+        return items_.GetAllocator();
+    }
+
+    // Возвращает количество элементов в массиве
+    SIMPLE_VECTOR_CONSTEXPR size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    // Возвращает вместимость массива
+    SIMPLE_VECTOR_CONSTEXPR size_t GetCapacity() const noexcept {
+        return items_.GetSize();
+    }
+
+    // Сообщает, пустой ли массив
+    SIMPLE_VECTOR_CONSTEXPR bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    // Возвращает ссылку на элемент с индексом index
+    SIMPLE_VECTOR_CONSTEXPR Type& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return items_[index];
+    }
+
+    // Возвращает константную ссылку на элемент с индексом index
+    SIMPLE_VECTOR_CONSTEXPR const Type& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return items_[index];
+    }
+
+    // Возвращает константную ссылку на элемент с индексом index
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    SIMPLE_VECTOR_CONSTEXPR Type& At(size_t index) {
+        if (index >= size_) {
+            using namespace std;
+            throw out_of_range("Item index is out of range"s);
+        }
+        return items_[index];
+    }
+
+    // Возвращает константную ссылку на элемент с индексом index
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    SIMPLE_VECTOR_CONSTEXPR const Type& At(size_t index) const {
+        if (index >= size_) {
+            using namespace std;
+            throw out_of_range("Item index is out of range"s);
+        }
+        return items_[index];
+    }
+
+    // Обнуляет размер массива, не изменяя его вместимость
+    // Элементы разрушаются, память остаётся за вектором
+    SIMPLE_VECTOR_CONSTEXPR void Clear() noexcept {
+        DestroyRange(Alloc(), Data(), DataEnd());
+        size_ = 0;
+        Invalidate();
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR void Reserve(size_t new_capacity) {
+        if (new_capacity > GetCapacity()) {
+            auto new_items = ReallocateCopy(new_capacity);  // может бросить исключение
+
+            items_.swap(new_items);
+            Invalidate();
+        }
+    }
+
+    // Уменьшает вместимость до размера вектора, возвращая лишнюю память распределителю.
+    // Пустой вектор освобождает буфер целиком
+    SIMPLE_VECTOR_CONSTEXPR void ShrinkToFit() {
+        if (GetCapacity() > size_) {
+            auto new_items = ReallocateCopy(size_);  // может бросить исключение
+
+            items_.swap(new_items);
+            Invalidate();
+        }
+    }
+
+    // Возвращает count неинициализированных ячеек за концом вектора, при необходимости увеличивая вместимость
+    // согласно GrowthPolicy. Размер вектора не меняется до вызова CommitAppend, поэтому ячейки можно заполнять
+    // в цикле без проверок вместимости. Ячейки заполняются присваиванием в обход AllocTraits::construct,
+    // поэтому метод доступен только для тривиальных типов, которым распределитель ничего не передаёт при создании.
+    // Любое изменение вектора до CommitAppend делает полученный диапазон недействительным
+    Span<Type> AppendUninitialized(size_t count) {
+        static_assert(std::is_trivial_v<Type>, "AppendUninitialized requires trivial type");
+        const size_t required = size_ + count;
+        if (required > GetCapacity()) {
+            Reserve(NextCapacity(required));  // может бросить исключение
+        }
+        return { DataEnd(), count };
+    }
+
+    // Добавляет в вектор первые count ячеек, полученных от AppendUninitialized.
+    // Все они к этому моменту должны содержать созданные элементы
+    void CommitAppend(size_t count) noexcept {
+        assert(size_ + count <= GetCapacity());
+        size_ += count;
+    }
+
+    // Изменяет размер массива.
+    // При увеличении размера новые элементы получают значение по умолчанию для типа Type
+    SIMPLE_VECTOR_CONSTEXPR void Resize(size_t new_size) {
+        ResizeWith(new_size, [this](Type* dst, size_t count) {
+            UninitializedConstructN(Alloc(), dst, count);  // может бросить исключение
+        });
+    }
+
+    // Изменяет размер массива, конструируя новые элементы параллельно в нескольких потоках
+    void Resize(size_t new_size, ParallelInit parallel) {
+        ResizeWith(new_size, [this, parallel](Type* dst, size_t count) {
+            ParallelUninitializedConstructN(Alloc(), dst, count, parallel);  // может бросить исключение
+        });
+    }
+
+    // Добавляет элемент в конец вектора
+    // При нехватке места увеличивает вместимость вектора согласно GrowthPolicy
+    SIMPLE_VECTOR_CONSTEXPR void PushBack(Type item) {
+        EmplaceBack(std::move(item));  // может бросить исключение
+    }
+
+    // Конструирует элемент из аргументов args непосредственно в конце вектора
+    // Возвращает ссылку на созданный элемент
+    // При нехватке места увеличивает вместимость вектора согласно GrowthPolicy
+    template <typename... Args>
+    SIMPLE_VECTOR_CONSTEXPR Type& EmplaceBack(Args&&... args) {
+        const size_t new_size = size_ + 1;
+        if (new_size > GetCapacity()) {
+            const size_t new_capacity = NextCapacity(new_size);
+
+            ItemsPtr new_items(new_capacity, items_.GetAllocator());  // может бросить исключение
+            // Новый элемент конструируется до переноса старых, поэтому args могут ссылаться на элементы вектора
+            AllocTraits::construct(Alloc(), new_items.Get() + size_, std::forward<Args>(args)...);  // может бросить исключение
+            try {
+                RelocateItems(new_items.Get());  // может бросить исключение
+            }
+            catch (...) {
+                AllocTraits::destroy(Alloc(), new_items.Get() + size_);
+                throw;
+            }
+
+            items_.swap(new_items);
+            Invalidate();
+        }
+        else {
+            AllocTraits::construct(Alloc(), DataEnd(), std::forward<Args>(args)...);  // может бросить исключение
+        }
+        size_ = new_size;
+        return items_[size_ - 1];
+    }
+
+    // Вставляет значение value в позицию pos.
+    // Возвращает итератор на вставленное значение
+    // Если перед вставкой значения вектор был заполнен полностью,
+    // вместимость вектора увеличивается согласно GrowthPolicy (по умолчанию вдвое, а для вектора вместимостью 0 становится равной 1)
+    SIMPLE_VECTOR_CONSTEXPR Iterator Insert(Iterator pos, Type value) {
+        return Emplace(pos, std::move(value));  // может выбросить исключение
+    }
+
+    // Конструирует элемент из аргументов args в позиции pos.
+    // Возвращает итератор на созданный элемент
+    // Если перед вставкой вектор был заполнен полностью, вместимость увеличивается согласно GrowthPolicy
+    template <typename... Args>
+    SIMPLE_VECTOR_CONSTEXPR Iterator Emplace(ConstIterator pos, Args&&... args) {
+        const Type* raw_pos = ToPointer(pos);
+        assert(Data() <= raw_pos && raw_pos <= DataEnd());
+        size_t new_size = size_ + 1;
+        size_t new_item_offset = raw_pos - Data();
+        if (new_size <= GetCapacity()) {  // Вместимость вектора достаточна для вставки элемента
+            Type* mutable_pos = Data() + new_item_offset;
+
+            if (mutable_pos == DataEnd()) {
+                AllocTraits::construct(Alloc(), DataEnd(), std::forward<Args>(args)...);  // может выбросить исключение
+            }
+            else if constexpr (IsTriviallyRelocatableV<Type>) {
+                Type value(std::forward<Args>(args)...);  // может выбросить исключение
+                // Сдвигаем "хвост" вправо одним memmove, ячейка pos становится неинициализированной
+                const size_t tail = DataEnd() - mutable_pos;
+                ShiftBytes(mutable_pos + 1, mutable_pos, tail);
+                try {
+                    AllocTraits::construct(Alloc(), mutable_pos, std::move(value));  // может выбросить исключение
+                }
+                catch (...) {
+                    // Возвращаем "хвост" на место, чтобы в [0, size_) не осталось неинициализированной ячейки
+                    ShiftBytes(mutable_pos, mutable_pos + 1, tail);
+                    throw;
+                }
+            }
+            else {
+                // args могут ссылаться на элементы вектора, поэтому элемент создаётся до сдвига "хвоста"
+                Type value(std::forward<Args>(args)...);  // может выбросить исключение
+                // Последний элемент переносим в неинициализированную ячейку за концом,
+                // остальные элементы "хвоста" сдвигаем вправо, начиная с последнего
+                Type* old_end = DataEnd();
+                AllocTraits::construct(Alloc(), old_end, std::move(*(old_end - 1)));  // может выбросить исключение
+                // Перенесённый элемент сразу включаем в вектор, чтобы при исключении ниже он был уничтожен вместе с остальными
+                ++size_;
+                Invalidate();
+                std::move_backward(mutable_pos, old_end - 1, old_end);  // может выбросить исключение
+                *mutable_pos = std::move(value);           // может выбросить исключение
+            }
+        }
+        else {  // Требуется перевыделить память
+            const size_t new_capacity = NextCapacity(new_size);
+
+            ItemsPtr new_items(new_capacity, items_.GetAllocator());  // может выбросить исключение
+            Type* new_items_pos = new_items.Get() + new_item_offset;
+
+            // Конструируем элемент сразу в позиции вставки
+            AllocTraits::construct(Alloc(), new_items_pos, std::forward<Args>(args)...);  // может выбросить исключение
+            try {
+                // Переносим элементы, окружающие вставляемый
+                RelocateItemsWithGap(new_items.Get(), new_item_offset, 1);  // может выбросить исключение
+            }
+            catch (...) {
+                AllocTraits::destroy(Alloc(), new_items_pos);
+                throw;
+            }
+
+            items_.swap(new_items);
+        }
+        size_ = new_size;
+        Invalidate();
+        return MakeIterator(Data() + new_item_offset);
+    }
+
+    // Удаляет элемент с конца вектора, не уменьшая его вместимость
+    SIMPLE_VECTOR_CONSTEXPR void PopBack() noexcept {
+        assert(!IsEmpty());
+        --size_;
+        AllocTraits::destroy(Alloc(), DataEnd());
+        Invalidate();
+    }
+
+    // Удаляет элемент вектора в позиции pos, сдвигая следующие элементы на его место.
+    // Итератор pos должен быть итератором, ссылающимся на существующий элемент вектора.
+    // Возвращает итератор на элемент, который следует за последним удалённым элементом.
+    // Если был удалён последний элемент, должен вернуться итератор DataEnd().
+    SIMPLE_VECTOR_CONSTEXPR Iterator Erase(Iterator pos) {
+        assert(Data() <= ToPointer(pos) && ToPointer(pos) < DataEnd());
+        return EraseRange(pos, pos + 1);  // может выбросить исключение
+    }
+
+    // Удаляет элементы [first, last), сдвигая "хвост" на их место одной операцией.
+    // Возвращает итератор на элемент, следовавший за последним удалённым
+    SIMPLE_VECTOR_CONSTEXPR Iterator EraseRange(ConstIterator first, ConstIterator last) {
+        Type* mutable_first = Data() + (ToPointer(first) - Data());
+        Type* mutable_last = Data() + (ToPointer(last) - Data());
+        assert(Data() <= mutable_first && mutable_first <= mutable_last && mutable_last <= DataEnd());
+        if (mutable_first == mutable_last) {
+            return MakeIterator(mutable_first);
+        }
+
+        if constexpr (IsTriviallyRelocatableV<Type>) {
+            // Разрушаем удаляемые элементы и сдвигаем "хвост" влево одним memmove
+            DestroyRange(Alloc(), mutable_first, mutable_last);
+            ShiftBytes(mutable_first, mutable_last, DataEnd() - mutable_last);
+            size_ -= mutable_last - mutable_first;
+        }
+        else {
+            // Переносим "хвост" влево на места удаляемых элементов и разрушаем освободившиеся в конце
+            Type* new_end = std::move(mutable_last, DataEnd(), mutable_first);  // может выбросить исключение
+            DestroyRange(Alloc(), new_end, DataEnd());
+            size_ = new_end - Data();
+        }
+        Invalidate();
+        return MakeIterator(mutable_first);
+    }
+
+    // Вставляет копии элементов [first, last) в позицию pos, сдвигая "хвост" один раз
+    // и перевыделяя память не более одного раза. Возвращает итератор на первый вставленный элемент.
+    // Итераторы не должны ссылаться на элементы самого вектора
+    template <typename InputIt>
+    SIMPLE_VECTOR_CONSTEXPR Iterator InsertRange(ConstIterator pos, InputIt first, InputIt last) {
+        const Type* raw_pos = ToPointer(pos);
+        assert(Data() <= raw_pos && raw_pos <= DataEnd());
+        const size_t offset = raw_pos - Data();
+        using Category = typename std::iterator_traits<InputIt>::iterator_category;
+        if constexpr (!std::is_base_of_v<std::forward_iterator_tag, Category>) {
+            // Однопроходный диапазон: сначала собираем элементы, чтобы узнать их количество
+            SimpleVector buffer(items_.GetAllocator());
+            for (; first != last; ++first) {
+                buffer.EmplaceBack(*first);  // может выбросить исключение
+            }
+            return InsertRange(pos, std::make_move_iterator(buffer.Data()), std::make_move_iterator(buffer.DataEnd()));
+        }
+        else {
+            const size_t count = std::distance(first, last);
+            const size_t new_size = size_ + count;
+            if (count == 0) {
+                return MakeIterator(Data() + offset);
+            }
+
+            if (new_size > GetCapacity()) {  // Требуется перевыделить память
+                ItemsPtr new_items(NextCapacity(new_size), items_.GetAllocator());  // может выбросить исключение
+                Type* gap = new_items.Get() + offset;
+                UninitializedCopy(Alloc(), first, last, gap);  // может выбросить исключение
+                try {
+                    RelocateItemsWithGap(new_items.Get(), offset, count);  // может выбросить исключение
+                }
+                catch (...) {
+                    DestroyRange(Alloc(), gap, gap + count);
+                    throw;
+                }
+                items_.swap(new_items);
+            }
+            else if constexpr (IsTriviallyRelocatableV<Type>) {
+                // Сдвигаем "хвост" одним memmove и конструируем элементы в освободившемся промежутке
+                Type* gap = Data() + offset;
+                const size_t tail = size_ - offset;
+                ShiftBytes(gap + count, gap, tail);
+                try {
+                    UninitializedCopy(Alloc(), first, last, gap);  // может выбросить исключение
+                }
+                catch (...) {
+                    ShiftBytes(gap, gap + count, tail);
+                    throw;
+                }
+            }
+            else {
+                Type* mutable_pos = Data() + offset;
+                Type* old_end = DataEnd();
+                const size_t tail = size_ - offset;
+                if (count < tail) {
+                    // Последние count элементов "хвоста" переносим в неинициализированную память за концом,
+                    // остальные сдвигаем внутри вектора и присваиваем вставляемые значения
+                    UninitializedMove(Alloc(), old_end - count, old_end, old_end);  // может выбросить исключение
+                    size_ = new_size;
+                    std::move_backward(mutable_pos, old_end - count, old_end);  // может выбросить исключение
+                    std::copy(first, last, mutable_pos);  // может выбросить исключение
+                }
+                else {
+                    // Часть вставляемых значений, выходящая за конец, конструируется в неинициализированной памяти,
+                    // весь "хвост" переносится за неё, остальные значения присваиваются на место "хвоста"
+                    InputIt middle = std::next(first, tail);
+                    UninitializedCopy(Alloc(), middle, last, old_end);  // может выбросить исключение
+                    size_ += count - tail;
+                    UninitializedMove(Alloc(), mutable_pos, old_end, old_end + (count - tail));  // может выбросить исключение
+                    size_ = new_size;
+                    std::copy(first, middle, mutable_pos);  // может выбросить исключение
+                }
+            }
+            size_ = new_size;
+            Invalidate();
+            return MakeIterator(Data() + offset);
+        }
+    }
+
+    // Добавляет копии элементов [first, last) в конец вектора, перевыделяя память не более одного раза
+    template <typename InputIt>
+    SIMPLE_VECTOR_CONSTEXPR void AppendRange(InputIt first, InputIt last) {
+        InsertRange(cend(), first, last);  // может выбросить исключение
+    }
+
+    // Заменяет содержимое вектора копиями элементов [first, last)
+    template <typename InputIt>
+    SIMPLE_VECTOR_CONSTEXPR void Assign(InputIt first, InputIt last) {
+        Clear();
+        AppendRange(first, last);  // может выбросить исключение
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR void Assign(std::initializer_list<Type> init) {
+        Assign(init.begin(), init.end());  // может выбросить исключение
+    }
+
+#if defined(__cpp_lib_ranges)
+    // Перегрузки для диапазонов C++20
+    template <std::ranges::input_range Range>
+    SIMPLE_VECTOR_CONSTEXPR Iterator InsertRange(ConstIterator pos, Range&& range) {
+        if constexpr (std::ranges::common_range<Range>) {
+            return InsertRange(pos, std::ranges::begin(range), std::ranges::end(range));  // может выбросить исключение
+        }
+        else {
+            auto common = std::views::common(std::forward<Range>(range));
+            return InsertRange(pos, common.begin(), common.end());  // может выбросить исключение
+        }
+    }
+
+    template <std::ranges::input_range Range>
+    SIMPLE_VECTOR_CONSTEXPR void AppendRange(Range&& range) {
+        InsertRange(cend(), std::forward<Range>(range));  // может выбросить исключение
+    }
+
+    template <std::ranges::input_range Range>
+    SIMPLE_VECTOR_CONSTEXPR void Assign(Range&& range) {
+        Clear();
+        AppendRange(std::forward<Range>(range));  // может выбросить исключение
+    }
+#endif
+
+    // Записывает вектор в поток в двоичном формате: заголовок BinaryHeader и элементы одним блоком.
+    // Выбрасывает std::runtime_error при ошибке записи
+    void WriteBinary(std::ostream& output) const {
+        static_assert(std::is_trivially_copyable_v<Type>, "Binary format supports only trivially copyable types");
+        BinaryHeader header;
+        header.element_size = sizeof(Type);
+        header.count = size_;
+        header.checksum = ComputeChecksum(Data(), size_ * sizeof(Type));
+        output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        output.write(reinterpret_cast<const char*>(Data()), static_cast<std::streamsize>(size_ * sizeof(Type)));
+        if (!output) {
+            throw std::runtime_error("Cannot write SimpleVector binary stream"s);
+        }
+    }
+
+    // Читает вектор, записанный WriteBinary. Элементы читаются прямо в буфер вектора
+    // без предварительного конструирования. Выбрасывает std::runtime_error,
+    // если поток обрывается, формат не совпадает или не сходится контрольная сумма.
+    // Количество элементов из заголовка не должно превышать длину оставшейся части потока, поэтому
+    // повреждённый заголовок не приводит к выделению огромного буфера: у потока с позиционированием
+    // элементы читаются одним блоком после проверки длины, у остальных - частями, и буфер растёт по мере чтения
+    static SimpleVector ReadBinary(std::istream& input, const Allocator& alloc = Allocator()) {
+        static_assert(std::is_trivially_copyable_v<Type>, "Binary format supports only trivially copyable types");
+        BinaryHeader header;
+        if (!input.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+            throw std::runtime_error("Truncated SimpleVector binary stream"s);
+        }
+        CheckBinaryHeader(header, sizeof(Type));
+
+        const std::streamoff remaining = RemainingStreamSize(input);
+        if (header.count > std::numeric_limits<size_t>::max() / sizeof(Type)
+            || (remaining >= 0 && header.count > static_cast<uint64_t>(remaining) / sizeof(Type))) {
+            throw std::runtime_error("Truncated SimpleVector binary stream"s);
+        }
+        const size_t count = static_cast<size_t>(header.count);
+        constexpr size_t FIRST_CHUNK = (size_t(1) << 16) / sizeof(Type) + 1;
+
+        size_t read_count = 0;
+        size_t capacity = remaining >= 0 ? count : std::min(count, FIRST_CHUNK);
+        ItemsPtr items(capacity, alloc);  // может бросить исключение
+        for (;;) {
+            const size_t bytes = (capacity - read_count) * sizeof(Type);
+            if (!input.read(reinterpret_cast<char*>(items.Get() + read_count), static_cast<std::streamsize>(bytes))) {
+                throw std::runtime_error("Truncated SimpleVector binary stream"s);
+            }
+            read_count = capacity;
+            if (read_count == count) {
+                break;
+            }
+            capacity = std::min(count, capacity * 2);
+            ItemsPtr grown(capacity, alloc);  // может бросить исключение
+            std::memcpy(grown.Get(), items.Get(), read_count * sizeof(Type));
+            items.swap(grown);
+        }
+        if (ComputeChecksum(items.Get(), count * sizeof(Type)) != header.checksum) {
+            throw std::runtime_error("SimpleVector binary stream checksum mismatch"s);
+        }
+        SimpleVector result(alloc);
+        result.items_.swap(items);
+        result.size_ = count;
+        return result;
+    }
+
+    // Обменивает значение с другим вектором
+    SIMPLE_VECTOR_CONSTEXPR void swap(SimpleVector& other) noexcept {
+        items_.swap(other.items_);
+        std::swap(size_, other.size_);
+        Invalidate();
+        other.Invalidate();
+    }
+
+    // Возвращает указатель на первый элемент массива
+    // Для пустого массива может быть равен (или не равен) nullptr
+    SIMPLE_VECTOR_CONSTEXPR Type* Data() noexcept {
+        return items_.Get();
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR const Type* Data() const noexcept {
+        return items_.Get();
+    }
+
+    // Возвращает итератор на начало массива
+    // Для пустого массива может быть равен (или не равен) nullptr
+    SIMPLE_VECTOR_CONSTEXPR Iterator begin() noexcept {
+        return MakeIterator(Data());
+    }
+
+    // Возвращает итератор на элемент, следующий за последним
+    // Для пустого массива может быть равен (или не равен) nullptr
+    SIMPLE_VECTOR_CONSTEXPR Iterator end() noexcept {
+        return MakeIterator(DataEnd());
+    }
+
+    // Возвращает константный итератор на начало массива
+    // Для пустого массива может быть равен (или не равен) nullptr
+    SIMPLE_VECTOR_CONSTEXPR ConstIterator begin() const noexcept {
+        return MakeIterator(Data());
+    }
+
+    // Возвращает итератор на элемент, следующий за последним
+    // Для пустого массива может быть равен (или не равен) nullptr
+    SIMPLE_VECTOR_CONSTEXPR ConstIterator end() const noexcept {
+        return MakeIterator(DataEnd());
+    }
+
+    // Возвращает константный итератор на начало массива
+    // Для пустого массива может быть равен (или не равен) nullptr
+    SIMPLE_VECTOR_CONSTEXPR ConstIterator cbegin() const noexcept {
+        return MakeIterator(Data());
+    }
+
+    // Возвращает итератор на элемент, следующий за последним
+    // Для пустого массива может быть равен (или не равен) nullptr
+    SIMPLE_VECTOR_CONSTEXPR ConstIterator cend() const noexcept {
+        return MakeIterator(DataEnd());
+    }
+
+private:
+    SIMPLE_VECTOR_CONSTEXPR Allocator& Alloc() noexcept {
+        return items_.GetAllocator();
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR Type* DataEnd() noexcept {
+        return items_.Get() + size_;
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR const Type* DataEnd() const noexcept {
+        return items_.Get() + size_;
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR Iterator MakeIterator(Type* ptr) noexcept {
+        if constexpr (CheckedIterators) {
+            return Iterator(this, ptr);
+        }
+        else {
+            return ptr;
+        }
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR ConstIterator MakeIterator(const Type* ptr) const noexcept {
+        if constexpr (CheckedIterators) {
+            return ConstIterator(this, ptr);
+        }
+        else {
+            return ptr;
+        }
+    }
+
+    // Возвращает указатель на позицию итератора pos.
+    // В режиме проверки итератор должен принадлежать этому вектору и не быть устаревшим
+    SIMPLE_VECTOR_CONSTEXPR const Type* ToPointer(ConstIterator pos) const {
+        if constexpr (CheckedIterators) {
+            if (pos.owner_ != this) {
+                throw logic_error("Iterator does not belong to this SimpleVector"s);
+            }
+            return pos.Base();
+        }
+        else {
+            return pos;
+        }
+    }
+
+    // Делает недействительными все итераторы, выданные вектором до этого момента.
+    // Вызывается операциями, которые перевыделяют память, сдвигают или разрушают элементы
+    SIMPLE_VECTOR_CONSTEXPR void Invalidate() noexcept {
+        if constexpr (CheckedIterators) {
+            ++this->generation_;
+        }
+    }
+
+    // Изменяет размер массива, конструируя недостающие элементы функцией construct(dst, count)
+    template <typename Construct>
+    SIMPLE_VECTOR_CONSTEXPR void ResizeWith(size_t new_size, Construct construct) {
+        if (new_size > GetCapacity()) {
+            const size_t new_capacity = NextCapacity(new_size);
+
+            ItemsPtr new_items(new_capacity, items_.GetAllocator());  // может бросить исключение
+            // Сначала конструируем добавленные элементы,
+            // чтобы при исключении исходный вектор остался нетронутым
+            construct(new_items.Get() + size_, new_size - size_);  // может бросить исключение
+            try {
+                // Переносим существующие элементы вектора на новое место
+                RelocateItems(new_items.Get());  // может бросить исключение
+            }
+            catch (...) {
+                DestroyRange(Alloc(), new_items.Get() + size_, new_items.Get() + new_size);
+                throw;
+            }
+
+            items_.swap(new_items);
+            Invalidate();
+        }
+        else if (new_size > size_) {
+            construct(DataEnd(), new_size - size_);  // может бросить исключение
+        }
+        else {
+            DestroyRange(Alloc(), Data() + new_size, DataEnd());
+            Invalidate();
+        }
+        size_ = new_size;
+    }
+
+    // Вычисляет вместимость, достаточную для размещения required элементов
+    SIMPLE_VECTOR_CONSTEXPR size_t NextCapacity(size_t required) const noexcept {
+        return std::max(GrowthPolicy::NextCapacity(GetCapacity()), required);
+    }
+
+    // Выделяет память заданной вместимости и переносит в неё элементы текущего массива
+    SIMPLE_VECTOR_CONSTEXPR ItemsPtr ReallocateCopy(size_t new_capacity) {
+        ItemsPtr new_items(new_capacity, items_.GetAllocator());  // может бросить исключение
+        RelocateItems(new_items.Get());  // может бросить исключение
+        return new_items;
+    }
+
+    // Переносит элементы [0, size_) в неинициализированную память dst
+    // и разрушает исходные элементы. Размер вектора не меняется
+    SIMPLE_VECTOR_CONSTEXPR void RelocateItems(Type* dst) {
+        UninitializedRelocate(Alloc(), Data(), DataEnd(), dst);  // может бросить исключение
+    }
+
+    // Переносит элементы [0, offset) в dst, а элементы [offset, size_) - в dst + offset + gap,
+    // оставляя между ними промежуток из gap ячеек, и разрушает исходные элементы.
+    // При исключении перенесённые копии разрушаются, исходный вектор не меняется
+    SIMPLE_VECTOR_CONSTEXPR void RelocateItemsWithGap(Type* dst, size_t offset, size_t gap) {
+        Type* middle = Data() + offset;
+        if constexpr (IsTriviallyRelocatableV<Type>) {
+            RelocateBytes<Type>(Data(), middle, dst);
+            RelocateBytes<Type>(middle, DataEnd(), dst + offset + gap);
+        }
+        else {
+            UninitializedMoveIfNoexcept(Alloc(), Data(), middle, dst);  // может бросить исключение
+            try {
+                UninitializedMoveIfNoexcept(Alloc(), middle, DataEnd(), dst + offset + gap);  // может бросить исключение
+            }
+            catch (...) {
+                DestroyRange(Alloc(), dst, dst + offset);
+                throw;
+            }
+            DestroyRange(Alloc(), Data(), DataEnd());
+        }
+    }
+
+    ItemsPtr items_;
+    size_t size_ = 0;
+};
+
+// Векторизованное сравнение массивов арифметических типов.
+// На x86 реализации для SSE2 и AVX2 выбираются во время выполнения по возможностям процессора,
+// на остальных платформах используется скалярная реализация.
+// Ядра SSE2 вызываются без проверки процессора, поэтому на i386 векторизация включается, только если компилятор
+// сам генерирует SSE2 (-msse2); на x86-64 SSE2 есть всегда
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#define SIMPLE_VECTOR_X86_SIMD 1
+#endif
+
+// Возвращает индекс первого различающегося байта массивов lhs и rhs длины size либо size, если массивы равны
+inline size_t FindFirstMismatchByteScalar(const unsigned char* lhs, const unsigned char* rhs, size_t size) noexcept {
+    size_t i = 0;
+    while (i < size && lhs[i] == rhs[i]) {
+        ++i;
+    }
+    return i;
+}
+
+// Возвращает индекс первого элемента, для которого lhs[i] и rhs[i] различаются.
+// При Ordered == false различаются элементы, для которых !(lhs[i] == rhs[i]) (как в operator==),
+// при Ordered == true - элементы, для которых lhs[i] < rhs[i] || rhs[i] < lhs[i] (как в lexicographical_compare)
+template <bool Ordered, typename Float>
+size_t FindFirstMismatchFloatScalar(const Float* lhs, const Float* rhs, size_t size) noexcept {
+    size_t i = 0;
+    if constexpr (Ordered) {
+        while (i < size && !(lhs[i] < rhs[i] || rhs[i] < lhs[i])) {
+            ++i;
+        }
+    }
+    else {
+        while (i < size && lhs[i] == rhs[i]) {
+            ++i;
+        }
+    }
+    return i;
+}
+
+#ifdef SIMPLE_VECTOR_X86_SIMD
+inline size_t FindFirstMismatchByteSse2(const unsigned char* lhs, const unsigned char* rhs, size_t size) noexcept {
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs + i));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs + i));
+        const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(a, b))) ^ 0xFFFFu;
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    return i + FindFirstMismatchByteScalar(lhs + i, rhs + i, size - i);
+}
+
+__attribute__((target("avx2")))
+inline size_t FindFirstMismatchByteAvx2(const unsigned char* lhs, const unsigned char* rhs, size_t size) noexcept {
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lhs + i));
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rhs + i));
+        const unsigned mask = ~static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b)));
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    return i + FindFirstMismatchByteSse2(lhs + i, rhs + i, size - i);
+}
+
+template <bool Ordered>
+size_t FindFirstMismatchFloatSse2(const float* lhs, const float* rhs, size_t size) noexcept {
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        const __m128 a = _mm_loadu_ps(lhs + i);
+        const __m128 b = _mm_loadu_ps(rhs + i);
+        const __m128 differ = Ordered ? _mm_or_ps(_mm_cmplt_ps(a, b), _mm_cmpgt_ps(a, b)) : _mm_cmpneq_ps(a, b);
+        const int mask = _mm_movemask_ps(differ);
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    return i + FindFirstMismatchFloatScalar<Ordered>(lhs + i, rhs + i, size - i);
+}
+
+template <bool Ordered>
+size_t FindFirstMismatchFloatSse2(const double* lhs, const double* rhs, size_t size) noexcept {
+    size_t i = 0;
+    for (; i + 2 <= size; i += 2) {
+        const __m128d a = _mm_loadu_pd(lhs + i);
+        const __m128d b = _mm_loadu_pd(rhs + i);
+        const __m128d differ = Ordered ? _mm_or_pd(_mm_cmplt_pd(a, b), _mm_cmpgt_pd(a, b)) : _mm_cmpneq_pd(a, b);
+        const int mask = _mm_movemask_pd(differ);
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    return i + FindFirstMismatchFloatScalar<Ordered>(lhs + i, rhs + i, size - i);
+}
+
+// _CMP_NEQ_OQ: упорядоченно не равны (lhs < rhs || lhs > rhs), _CMP_NEQ_UQ: !(lhs == rhs)
+template <bool Ordered>
+__attribute__((target("avx2")))
+size_t FindFirstMismatchFloatAvx2(const float* lhs, const float* rhs, size_t size) noexcept {
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        const __m256 a = _mm256_loadu_ps(lhs + i);
+        const __m256 b = _mm256_loadu_ps(rhs + i);
+        const __m256 differ = Ordered ? _mm256_cmp_ps(a, b, _CMP_NEQ_OQ) : _mm256_cmp_ps(a, b, _CMP_NEQ_UQ);
+        const int mask = _mm256_movemask_ps(differ);
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    return i + FindFirstMismatchFloatSse2<Ordered>(lhs + i, rhs + i, size - i);
+}
+
+template <bool Ordered>
+__attribute__((target("avx2")))
+size_t FindFirstMismatchFloatAvx2(const double* lhs, const double* rhs, size_t size) noexcept {
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        const __m256d a = _mm256_loadu_pd(lhs + i);
+        const __m256d b = _mm256_loadu_pd(rhs + i);
+        const __m256d differ = Ordered ? _mm256_cmp_pd(a, b, _CMP_NEQ_OQ) : _mm256_cmp_pd(a, b, _CMP_NEQ_UQ);
+        const int mask = _mm256_movemask_pd(differ);
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    return i + FindFirstMismatchFloatSse2<Ordered>(lhs + i, rhs + i, size - i);
+}
+
+// Проверка поддержки AVX2 выполняется один раз за время работы программы
+inline bool HasAvx2() noexcept {
+    static const bool has_avx2 = __builtin_cpu_supports("avx2");
+    return has_avx2;
+}
+#endif
+
+inline size_t FindFirstMismatchByte(const unsigned char* lhs, const unsigned char* rhs, size_t size) noexcept {
+#ifdef SIMPLE_VECTOR_X86_SIMD
+    return HasAvx2() ? FindFirstMismatchByteAvx2(lhs, rhs, size) : FindFirstMismatchByteSse2(lhs, rhs, size);
+#else
+    return FindFirstMismatchByteScalar(lhs, rhs, size);
+#endif
+}
+
+template <bool Ordered, typename Float>
+size_t FindFirstMismatchFloat(const Float* lhs, const Float* rhs, size_t size) noexcept {
+#ifdef SIMPLE_VECTOR_X86_SIMD
+    return HasAvx2() ? FindFirstMismatchFloatAvx2<Ordered>(lhs, rhs, size) : FindFirstMismatchFloatSse2<Ordered>(lhs, rhs, size);
+#else
+    return FindFirstMismatchFloatScalar<Ordered>(lhs, rhs, size);
+#endif
+}
+
+// Целые числа равны тогда и только тогда, когда совпадают их байтовые представления.
+// Перечисления сюда не входят: для них может быть определён собственный operator==
+template <typename Type>
+inline constexpr bool IsBytewiseComparableV = std::is_integral_v<Type> || std::is_pointer_v<Type>;
+
+template <typename Type>
+inline constexpr bool IsSimdFloatV = std::is_same_v<Type, float> || std::is_same_v<Type, double>;
+
+// Проверяет равенство массивов lhs и rhs из size элементов
+template <typename Type>
+SIMPLE_VECTOR_CONSTEXPR bool RangeEqual(const Type* lhs, const Type* rhs, size_t size) {
+    if (IsConstantEvaluated()) {
+        return std::equal(lhs, lhs + size, rhs);  // может бросить исключение
+    }
+    if constexpr (IsBytewiseComparableV<Type>) {
+        return size == 0 || std::memcmp(lhs, rhs, size * sizeof(Type)) == 0;
+    }
+    else if constexpr (IsSimdFloatV<Type>) {
+        return FindFirstMismatchFloat<false>(lhs, rhs, size) == size;
+    }
+    else {
+        return std::equal(lhs, lhs + size, rhs);  // может бросить исключение
+    }
+}
+
+// Лексикографически сравнивает массив lhs из lhs_size элементов с массивом rhs из rhs_size элементов
+template <typename Type>
+SIMPLE_VECTOR_CONSTEXPR bool RangeLess(const Type* lhs, size_t lhs_size, const Type* rhs, size_t rhs_size) {
+    if (IsConstantEvaluated()) {
+        return std::lexicographical_compare(lhs, lhs + lhs_size, rhs, rhs + rhs_size);  // может бросить исключение
+    }
+    const size_t common_size = std::min(lhs_size, rhs_size);
+    size_t mismatch = common_size;
+    if constexpr ((std::is_integral_v<Type> && std::is_unsigned_v<Type> && sizeof(Type) == 1)) {
+        // memcmp сравнивает байты как unsigned char
+        const int result = common_size == 0 ? 0 : std::memcmp(lhs, rhs, common_size);
+        return result != 0 ? result < 0 : lhs_size < rhs_size;
+    }
+    else if constexpr (std::is_integral_v<Type>) {
+        mismatch = FindFirstMismatchByte(reinterpret_cast<const unsigned char*>(lhs),
+            reinterpret_cast<const unsigned char*>(rhs), common_size * sizeof(Type)) / sizeof(Type);
+    }
+    else if constexpr (IsSimdFloatV<Type>) {
+        mismatch = FindFirstMismatchFloat<true>(lhs, rhs, common_size);
+    }
+    else {
+        return std::lexicographical_compare(lhs, lhs + lhs_size, rhs, rhs + rhs_size);  // может бросить исключение
+    }
+    return mismatch != common_size ? lhs[mismatch] < rhs[mismatch] : lhs_size < rhs_size;
+}
+
+template <typename Type, typename Allocator, typename GrowthPolicy, bool CheckedIterators>
+inline SIMPLE_VECTOR_CONSTEXPR bool operator==(const SimpleVector<Type, Allocator, GrowthPolicy, CheckedIterators>& lhs, const SimpleVector<Type, Allocator, GrowthPolicy, CheckedIterators>& rhs) {
+    return (lhs.GetSize() == rhs.GetSize())
+        && RangeEqual(lhs.Data(), rhs.Data(), lhs.GetSize());  // может бросить исключение
+}
+
+template <typename Type, typename Allocator, typename GrowthPolicy, bool CheckedIterators>
+inline SIMPLE_VECTOR_CONSTEXPR bool operator!=(const SimpleVector<Type, Allocator, GrowthPolicy, CheckedIterators>& lhs, const SimpleVector<Type, Allocator, GrowthPolicy, CheckedIterators>& rhs) {
+    return !(lhs == rhs);  // может бросить исключение
+}
+
+template <typename Type, typename Allocator, typename GrowthPolicy, bool CheckedIterators>
+inline SIMPLE_VECTOR_CONSTEXPR bool operator<(const SimpleVector<Type, Allocator, GrowthPolicy, CheckedIterators>& lhs, const SimpleVector<Type, Allocator, GrowthPolicy, CheckedIterators>& rhs) {
+    return RangeLess(lhs.Data(), lhs.GetSize(), rhs.Data(), rhs.GetSize());  // может бросить исключение
+}
+
+template <typename Type, typename Allocator, typename GrowthPolicy, bool CheckedIterators>
+inline SIMPLE_VECTOR_CONSTEXPR bool operator<=(const SimpleVector<Type, Allocator, GrowthPolicy, CheckedIterators>& lhs, const SimpleVector<Type, Allocator, GrowthPolicy, CheckedIterators>& rhs) {
+    return !(rhs < lhs);  // может бросить исключение
+}
+
+template <typename Type, typename Allocator, typename GrowthPolicy, bool CheckedIterators>
+inline SIMPLE_VECTOR_CONSTEXPR bool operator>(const SimpleVector<Type, Allocator, GrowthPolicy, CheckedIterators>& lhs, const SimpleVector<Type, Allocator, GrowthPolicy, CheckedIterators>& rhs) {
+    return rhs < lhs;  // может бросить исключение
+}
+
+template <typename Type, typename Allocator, typename GrowthPolicy, bool CheckedIterators>
+inline SIMPLE_VECTOR_CONSTEXPR bool operator>=(const SimpleVector<Type, Allocator, GrowthPolicy, CheckedIterators>& lhs, const SimpleVector<Type, Allocator, GrowthPolicy, CheckedIterators>& rhs) {
+    return rhs <= lhs;  // может бросить исключение
+}
+
+// Вектор с оптимизацией малого размера:
+// до N элементов хранятся во внутреннем буфере объекта, при превышении переносятся в кучу.
+// Вместимость растёт согласно GrowthPolicy, как у SimpleVector
+template <typename Type, size_t N, typename GrowthPolicy = DoublingGrowth>
+class SmallVector {
+    static_assert(N > 0, "SmallVector requires non-zero inline capacity");
+    using ItemsPtr = ArrayPtr<Type, true>;
+
+public:
+    using Iterator = Type*;
+    using ConstIterator = const Type*;
+
+    SmallVector() noexcept = default;
+
+    // Создаёт вектор из size элементов, инициализированных значением по умолчанию
+    explicit SmallVector(size_t size) {
+        Resize(size);  // может бросить исключение
+    }
+
+    // Создаёт вектор из size элементов, инициализированных значением value
+    SmallVector(size_t size, const Type& value) {
+        Reserve(size);  // может бросить исключение
+        std::uninitialized_fill_n(Data(), size, value);  // может бросить исключение
+        size_ = size;
+    }
+
+    // Создаёт вектор из initializer_list
+    SmallVector(std::initializer_list<Type> init) {
+        Reserve(init.size());  // может бросить исключение
+        std::uninitialized_copy(init.begin(), init.end(), Data());  // может бросить исключение
+        size_ = init.size();
+    }
+
+    SmallVector(ReserveProxyObj reserved) {
+        Reserve(reserved.capacity);  // может бросить исключение
+    }
+
+    SmallVector(const SmallVector& other) {
+        Reserve(other.size_);  // может бросить исключение
+        std::uninitialized_copy(other.begin(), other.end(), Data());  // может бросить исключение
+        size_ = other.size_;
+    }
+
+    // Буфер в куче перехватывается за O(1), элементы внутреннего буфера переносятся поэлементно
+    SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<Type>) {
+        TakeFrom(other);
+    }
+
+    SmallVector& operator=(const SmallVector& rhs) {
+        if (&rhs != this) {
+            // Применяем идиому Copy-and-swap
+            SmallVector rhs_copy(rhs);  // может бросить исключение
+            swap(rhs_copy);
+        }
+        return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& rhs) noexcept(std::is_nothrow_move_constructible_v<Type>) {
+        if (&rhs != this) {
+            Clear();
+            ItemsPtr().swap(heap_items_);
+            capacity_ = N;
+            TakeFrom(rhs);
+        }
+        return *this;
+    }
+
+    ~SmallVector() {
+        std::destroy_n(Data(), size_);
+    }
+
+    // Возвращает количество элементов в массиве
+    size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    // Возвращает вместимость массива
+    size_t GetCapacity() const noexcept {
+        return capacity_;
+    }
+
+    // Сообщает, пустой ли массив
+    bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    // Сообщает, хранятся ли элементы во внутреннем буфере объекта
+    bool IsInline() const noexcept {
+        return !heap_items_;
+    }
+
+    // Возвращает ссылку на элемент с индексом index
+    Type& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return Data()[index];
+    }
+
+    // Возвращает константную ссылку на элемент с индексом index
+    const Type& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return Data()[index];
+    }
+
+    // Возвращает ссылку на элемент с индексом index
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    Type& At(size_t index) {
+        if (index >= size_) {
+            throw out_of_range("Item index is out of range"s);
+        }
+        return Data()[index];
+    }
+
+    // Возвращает константную ссылку на элемент с индексом index
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    const Type& At(size_t index) const {
+        if (index >= size_) {
+            throw out_of_range("Item index is out of range"s);
+        }
+        return Data()[index];
+    }
+
+    // Обнуляет размер массива, не изменяя его вместимость
+    void Clear() noexcept {
+        std::destroy_n(Data(), size_);
+        size_ = 0;
+    }
+
+    // Увеличивает вместимость до new_capacity, перенося элементы в кучу
+    void Reserve(size_t new_capacity) {
+        if (new_capacity > capacity_) {
+            ItemsPtr new_items(new_capacity);  // может бросить исключение
+            UninitializedRelocate(begin(), end(), new_items.Get());  // может бросить исключение
+            heap_items_.swap(new_items);
+            capacity_ = new_capacity;
+        }
+    }
+
+    // Изменяет размер массива.
+    // При увеличении размера новые элементы получают значение по умолчанию для типа Type
+    void Resize(size_t new_size) {
+        if (new_size > size_) {
+            if (new_size > capacity_) {
+                Reserve(NextCapacity(new_size));  // может бросить исключение
+            }
+            std::uninitialized_value_construct(end(), Data() + new_size);  // может бросить исключение
+        }
+        else {
+            std::destroy(Data() + new_size, end());
+        }
+        size_ = new_size;
+    }
+
+    // Добавляет элемент в конец вектора
+    // При нехватке места увеличивает вместимость вектора согласно GrowthPolicy
+    void PushBack(Type item) {
+        EmplaceBack(std::move(item));  // может бросить исключение
+    }
+
+    // Конструирует элемент из аргументов args в конце вектора
+    // Возвращает ссылку на созданный элемент
+    template <typename... Args>
+    Type& EmplaceBack(Args&&... args) {
+        if (size_ == capacity_) {
+            // args могут ссылаться на элементы вектора, поэтому элемент создаётся до переноса
+            Type value(std::forward<Args>(args)...);  // может бросить исключение
+            Reserve(NextCapacity(size_ + 1));  // может бросить исключение
+            new (end()) Type(std::move(value));  // может бросить исключение
+        }
+        else {
+            new (end()) Type(std::forward<Args>(args)...);  // может бросить исключение
+        }
+        ++size_;
+        return Data()[size_ - 1];
+    }
+
+    // Вставляет значение value в позицию pos.
+    // Возвращает итератор на вставленное значение
+    Iterator Insert(ConstIterator pos, Type value) {
+        return Emplace(pos, std::move(value));  // может бросить исключение
+    }
+
+    // Конструирует элемент из аргументов args в позиции pos.
+    // Возвращает итератор на созданный элемент
+    template <typename... Args>
+    Iterator Emplace(ConstIterator pos, Args&&... args) {
+        assert(cbegin() <= pos && pos <= cend());
+        const size_t offset = pos - cbegin();
+        if (offset == size_) {
+            EmplaceBack(std::forward<Args>(args)...);  // может бросить исключение
+            return begin() + offset;
+        }
+
+        Type value(std::forward<Args>(args)...);  // может бросить исключение
+        if (size_ == capacity_) {
+            Reserve(NextCapacity(size_ + 1));  // может бросить исключение
+        }
+        Iterator mutable_pos = begin() + offset;
+        // Последний элемент переносим в неинициализированную ячейку за концом,
+        // остальные элементы "хвоста" сдвигаем вправо, начиная с последнего
+        new (end()) Type(std::move(*(end() - 1)));  // может бросить исключение
+        ++size_;
+        std::move_backward(mutable_pos, end() - 2, end() - 1);  // может бросить исключение
+        *mutable_pos = std::move(value);  // может бросить исключение
+        return mutable_pos;
+    }
+
+    // Удаляет элемент с конца вектора, не уменьшая его вместимость
+    void PopBack() noexcept {
+        assert(!IsEmpty());
+        --size_;
+        std::destroy_at(Data() + size_);
+    }
+
+    // Удаляет элемент вектора в позиции pos, сдвигая следующие элементы на его место.
+    // Возвращает итератор на элемент, который следует за удалённым
+    Iterator Erase(ConstIterator pos) {
+        assert(cbegin() <= pos && pos < cend());
+        Iterator mutable_pos = begin() + (pos - cbegin());
+        std::move(mutable_pos + 1, end(), mutable_pos);  // может бросить исключение
+        PopBack();
+        return mutable_pos;
+    }
+
+    // Обменивает значение с другим вектором
+    void swap(SmallVector& other) noexcept(std::is_nothrow_move_constructible_v<Type>) {
+        SmallVector tmp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(tmp);
+    }
+
+    Iterator begin() noexcept {
+        return Data();
+    }
+
+    Iterator end() noexcept {
+        return Data() + size_;
+    }
+
+    ConstIterator begin() const noexcept {
+        return Data();
+    }
+
+    ConstIterator end() const noexcept {
+        return Data() + size_;
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return Data();
+    }
+
+    ConstIterator cend() const noexcept {
+        return Data() + size_;
+    }
+
+private:
+    Type* Data() noexcept {
+        return heap_items_ ? heap_items_.Get() : reinterpret_cast<Type*>(inline_items_);
+    }
+
+    const Type* Data() const noexcept {
+        return heap_items_ ? heap_items_.Get() : reinterpret_cast<const Type*>(inline_items_);
+    }
+
+    // Вычисляет вместимость, достаточную для размещения required элементов
+    size_t NextCapacity(size_t required) const noexcept {
+        return std::max(GrowthPolicy::NextCapacity(capacity_), required);
+    }
+
+    // Забирает элементы other в пустой вектор со внутренним буфером, other становится пустым
+    void TakeFrom(SmallVector& other) noexcept(std::is_nothrow_move_constructible_v<Type>) {
+        assert(IsEmpty() && IsInline());
+        if (other.IsInline()) {
+            UninitializedRelocate(other.begin(), other.end(), Data());
+        }
+        else {
+            heap_items_.swap(other.heap_items_);
+            capacity_ = other.capacity_;
+            other.capacity_ = N;
+        }
+        size_ = other.size_;
+        other.size_ = 0;
+    }
+
+    ItemsPtr heap_items_;
+    alignas(Type) unsigned char inline_items_[sizeof(Type) * N];
+    size_t size_ = 0;
+    size_t capacity_ = N;
+};
+
+template <typename Type, size_t N, typename GrowthPolicy>
+inline bool operator==(const SmallVector<Type, N, GrowthPolicy>& lhs, const SmallVector<Type, N, GrowthPolicy>& rhs) {
+    return (lhs.GetSize() == rhs.GetSize())
+        && RangeEqual(lhs.begin(), rhs.begin(), lhs.GetSize());  // может бросить исключение
+}
+
+template <typename Type, size_t N, typename GrowthPolicy>
+inline bool operator!=(const SmallVector<Type, N, GrowthPolicy>& lhs, const SmallVector<Type, N, GrowthPolicy>& rhs) {
+    return !(lhs == rhs);  // может бросить исключение
+}
+
+template <typename Type, size_t N, typename GrowthPolicy>
+inline bool operator<(const SmallVector<Type, N, GrowthPolicy>& lhs, const SmallVector<Type, N, GrowthPolicy>& rhs) {
+    return RangeLess(lhs.begin(), lhs.GetSize(), rhs.begin(), rhs.GetSize());  // может бросить исключение
+}
+
+template <typename Type, size_t N, typename GrowthPolicy>
+inline bool operator<=(const SmallVector<Type, N, GrowthPolicy>& lhs, const SmallVector<Type, N, GrowthPolicy>& rhs) {
+    return !(rhs < lhs);  // может бросить исключение
+}
+
+template <typename Type, size_t N, typename GrowthPolicy>
+inline bool operator>(const SmallVector<Type, N, GrowthPolicy>& lhs, const SmallVector<Type, N, GrowthPolicy>& rhs) {
+    return rhs < lhs;  // может бросить исключение
+}
+
+template <typename Type, size_t N, typename GrowthPolicy>
+inline bool operator>=(const SmallVector<Type, N, GrowthPolicy>& lhs, const SmallVector<Type, N, GrowthPolicy>& rhs) {
+    return rhs <= lhs;  // может бросить исключение
+}
+
+#ifdef SIMPLE_VECTOR_HAS_MMAP
+// Режим открытия файла для MappedVector
+enum class MapMode {
+    // Файл открывается только для чтения. Изменения элементов остаются в памяти процесса
+    // (отображение копируется при записи), изменение размера запрещено
+    ReadOnly,
+    // Файл открывается для чтения и записи и создаётся, если не существует
+    ReadWrite,
+};
+
+// Вектор тривиально копируемых элементов, хранящийся в отображённом в память файле.
+// Файл - это плотный массив элементов без заголовка, размер вектора равен размеру файла, делённому на sizeof(Type).
+// Элементы подгружаются с диска страницами при первом обращении, поэтому открытие не зависит от размера файла.
+// В режиме ReadWrite вместимость растёт за счёт ftruncate и mremap, а при закрытии файл обрезается до размера вектора,
+// поэтому для записи открываются только файлы, длина которых кратна sizeof(Type)
+template <typename Type, typename GrowthPolicy = DoublingGrowth>
+class MappedVector {
+    static_assert(std::is_trivially_copyable_v<Type>, "MappedVector supports only trivially copyable types");
+
+public:
+    using Iterator = Type*;
+    using ConstIterator = const Type*;
+
+    // Открывает файл path и отображает его содержимое в память.
+    // Выбрасывает std::system_error, если файл не удалось открыть или отобразить,
+    // и std::runtime_error, если в режиме ReadWrite длина файла не кратна sizeof(Type):
+    // иначе при закрытии неполный последний элемент был бы отрезан
+    MappedVector(const std::string& path, MapMode mode)
+        : mode_(mode) {
+        const int flags = mode == MapMode::ReadOnly ? O_RDONLY : O_RDWR | O_CREAT;
+        fd_ = open(path.c_str(), flags, 0644);
+        if (fd_ < 0) {
+            throw std::system_error(errno, std::generic_category(), "Cannot open "s + path);
+        }
+        struct stat file_stat {};
+        if (fstat(fd_, &file_stat) != 0) {
+            const int error = errno;
+            close(fd_);
+            throw std::system_error(error, std::generic_category(), "Cannot stat "s + path);
+        }
+        if (mode == MapMode::ReadWrite && static_cast<size_t>(file_stat.st_size) % sizeof(Type) != 0) {
+            close(fd_);
+            throw std::runtime_error("File size is not a multiple of the element size: "s + path);
+        }
+        size_ = static_cast<size_t>(file_stat.st_size) / sizeof(Type);
+        try {
+            Map(size_);  // может бросить исключение
+        }
+        catch (...) {
+            close(fd_);
+            throw;
+        }
+    }
+
+    MappedVector(const MappedVector&) = delete;
+    MappedVector& operator=(const MappedVector&) = delete;
+
+    MappedVector(MappedVector&& other) noexcept
+        : fd_(std::exchange(other.fd_, -1))
+        , mode_(other.mode_)
+        , items_(std::exchange(other.items_, nullptr))
+        , size_(std::exchange(other.size_, 0))
+        , capacity_(std::exchange(other.capacity_, 0)) {
+    }
+
+    MappedVector& operator=(MappedVector&& rhs) noexcept {
+        if (&rhs != this) {
+            Close();
+            fd_ = std::exchange(rhs.fd_, -1);
+            mode_ = rhs.mode_;
+            items_ = std::exchange(rhs.items_, nullptr);
+            size_ = std::exchange(rhs.size_, 0);
+            capacity_ = std::exchange(rhs.capacity_, 0);
+        }
+        return *this;
+    }
+
+    // Снимает отображение и обрезает файл до размера вектора
+    ~MappedVector() {
+        Close();
+    }
+
+    // Возвращает количество элементов в массиве
+    size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    // Возвращает вместимость массива
+    size_t GetCapacity() const noexcept {
+        return capacity_;
+    }
+
+    // Сообщает, пустой ли массив
+    bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    // Возвращает ссылку на элемент с индексом index
+    Type& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return items_[index];
+    }
+
+    // Возвращает константную ссылку на элемент с индексом index
+    const Type& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return items_[index];
+    }
+
+    // Возвращает ссылку на элемент с индексом index
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    Type& At(size_t index) {
+        if (index >= size_) {
+            throw out_of_range("Item index is out of range"s);
+        }
+        return items_[index];
+    }
+
+    // Возвращает константную ссылку на элемент с индексом index
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    const Type& At(size_t index) const {
+        if (index >= size_) {
+            throw out_of_range("Item index is out of range"s);
+        }
+        return items_[index];
+    }
+
+    // Обнуляет размер массива, не изменяя его вместимость
+    void Clear() noexcept {
+        size_ = 0;
+    }
+
+    // Увеличивает вместимость, расширяя файл.
+    // Выбрасывает std::logic_error в режиме ReadOnly и std::system_error при ошибке расширения
+    void Reserve(size_t new_capacity) {
+        if (new_capacity > capacity_) {
+            CheckWritable();  // может бросить исключение
+            if (ftruncate(fd_, static_cast<off_t>(new_capacity * sizeof(Type))) != 0) {
+                throw std::system_error(errno, std::generic_category(), "Cannot extend mapped file"s);
+            }
+            Map(new_capacity);  // может бросить исключение
+        }
+    }
+
+    // Изменяет размер массива.
+    // При увеличении размера новые элементы получают значение по умолчанию для типа Type
+    void Resize(size_t new_size) {
+        if (new_size > capacity_) {
+            Reserve(std::max(GrowthPolicy::NextCapacity(capacity_), new_size));  // может бросить исключение
+        }
+        if (new_size > size_) {
+            std::fill(items_ + size_, items_ + new_size, Type{});
+        }
+        size_ = new_size;
+    }
+
+    // Добавляет элемент в конец вектора
+    // При нехватке места увеличивает вместимость вектора согласно GrowthPolicy
+    void PushBack(const Type& item) {
+        if (size_ == capacity_) {
+            const Type copy = item;  // item может ссылаться на элемент, который станет недоступен после перевыделения
+            Reserve(std::max(GrowthPolicy::NextCapacity(capacity_), size_ + 1));  // может бросить исключение
+            items_[size_++] = copy;
+        }
+        else {
+            items_[size_++] = item;
+        }
+    }
+
+    // Удаляет элемент с конца вектора, не уменьшая его вместимость
+    void PopBack() noexcept {
+        assert(!IsEmpty());
+        --size_;
+    }
+
+    // Сбрасывает изменённые страницы на диск
+    void Flush() {
+        if (mode_ == MapMode::ReadWrite && items_ != nullptr && msync(items_, capacity_ * sizeof(Type), MS_SYNC) != 0) {
+            throw std::system_error(errno, std::generic_category(), "Cannot flush mapped file"s);
+        }
+    }
+
+    Iterator begin() noexcept {
+        return items_;
+    }
+
+    Iterator end() noexcept {
+        return items_ + size_;
+    }
+
+    ConstIterator begin() const noexcept {
+        return items_;
+    }
+
+    ConstIterator end() const noexcept {
+        return items_ + size_;
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return items_;
+    }
+
+    ConstIterator cend() const noexcept {
+        return items_ + size_;
+    }
+
+private:
+    void CheckWritable() const {
+        if (mode_ != MapMode::ReadWrite) {
+            throw std::logic_error("MappedVector opened read-only cannot grow"s);
+        }
+    }
+
+    // Отображает (или переотображает) первые new_capacity элементов файла
+    void Map(size_t new_capacity) {
+        const size_t new_bytes = new_capacity * sizeof(Type);
+        void* mapped = nullptr;
+        if (new_bytes == 0) {
+            Unmap();
+            return;
+        }
+        if (items_ == nullptr) {
+            const int flags = mode_ == MapMode::ReadOnly ? MAP_PRIVATE : MAP_SHARED;
+            mapped = mmap(nullptr, new_bytes, PROT_READ | PROT_WRITE, flags, fd_, 0);
+        }
+        else {
+#ifdef __linux__
+            mapped = mremap(items_, capacity_ * sizeof(Type), new_bytes, MREMAP_MAYMOVE);
+#else
+            mapped = mmap(nullptr, new_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+            if (mapped != MAP_FAILED) {
+                Unmap();
+            }
+#endif
+        }
+        if (mapped == MAP_FAILED) {
+            throw std::system_error(errno, std::generic_category(), "Cannot map file"s);
+        }
+        items_ = static_cast<Type*>(mapped);
+        capacity_ = new_capacity;
+    }
+
+    void Unmap() noexcept {
+        if (items_ != nullptr) {
+            munmap(items_, capacity_ * sizeof(Type));
+            items_ = nullptr;
+        }
+        capacity_ = 0;
+    }
+
+    void Close() noexcept {
+        if (fd_ < 0) {
+            return;
+        }
+        Unmap();
+        if (mode_ == MapMode::ReadWrite) {
+            // Ошибку обрезки в деструкторе сообщить некому: в худшем случае в конце файла останутся нули
+            [[maybe_unused]] const int result = ftruncate(fd_, static_cast<off_t>(size_ * sizeof(Type)));
+        }
+        close(fd_);
+        fd_ = -1;
+    }
+
+    int fd_ = -1;
+    MapMode mode_ = MapMode::ReadOnly;
+    Type* items_ = nullptr;
+    size_t size_ = 0;
+    size_t capacity_ = 0;
+};
+#endif
+
+// Представление массива в двоичном формате SimpleVector::WriteBinary, лежащего в памяти
+// (например, в отображённом файле). Элементы не копируются: итераторы указывают прямо в исходную память
+template <typename Type>
+class BinaryView {
+    static_assert(std::is_trivially_copyable_v<Type>, "Binary format supports only trivially copyable types");
+
+public:
+    using ConstIterator = const Type*;
+
+    BinaryView() noexcept = default;
+
+    // Разбирает заголовок в памяти [data, data + size) и проверяет контрольную сумму.
+    // Выбрасывает std::runtime_error, если данные повреждены или не выровнены для Type
+    BinaryView(const void* data, size_t size) {
+        if (size < sizeof(BinaryHeader)) {
+            throw std::runtime_error("Truncated SimpleVector binary data"s);
+        }
+        BinaryHeader header;
+        std::memcpy(&header, data, sizeof(header));
+        CheckBinaryHeader(header, sizeof(Type));
+        if (header.count > (size - sizeof(BinaryHeader)) / sizeof(Type)) {
+            throw std::runtime_error("Truncated SimpleVector binary data"s);
+        }
+        const unsigned char* items = static_cast<const unsigned char*>(data) + sizeof(BinaryHeader);
+        if (reinterpret_cast<uintptr_t>(items) % alignof(Type) != 0) {
+            throw std::runtime_error("Misaligned SimpleVector binary data"s);
+        }
+        if (ComputeChecksum(items, header.count * sizeof(Type)) != header.checksum) {
+            throw std::runtime_error("SimpleVector binary data checksum mismatch"s);
+        }
+        items_ = reinterpret_cast<const Type*>(items);
+        size_ = header.count;
+    }
+
+    size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    const Type& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return items_[index];
+    }
+
+    ConstIterator begin() const noexcept {
+        return items_;
+    }
+
+    ConstIterator end() const noexcept {
+        return items_ + size_;
+    }
+
+private:
+    const Type* items_ = nullptr;
+    size_t size_ = 0;
+};
+
+#ifdef SIMPLE_VECTOR_HAS_MMAP
+// Файл в двоичном формате SimpleVector::WriteBinary, отображённый в память только для чтения.
+// Доступ к элементам через View() не копирует данные: страницы подгружаются при первом обращении
+template <typename Type>
+class MappedBinaryFile {
+public:
+    // Выбрасывает std::system_error, если файл не удалось открыть или отобразить,
+    // и std::runtime_error, если содержимое не в двоичном формате
+    explicit MappedBinaryFile(const std::string& path) {
+        const int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(), "Cannot open "s + path);
+        }
+        struct stat file_stat {};
+        if (fstat(fd, &file_stat) != 0 || file_stat.st_size == 0) {
+            const int error = file_stat.st_size == 0 ? EINVAL : errno;
+            close(fd);
+            throw std::system_error(error, std::generic_category(), "Cannot map "s + path);
+        }
+        size_ = static_cast<size_t>(file_stat.st_size);
+        data_ = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        const int error = errno;
+        close(fd);  // отображение остаётся действительным после закрытия файла
+        if (data_ == MAP_FAILED) {
+            data_ = nullptr;
+            throw std::system_error(error, std::generic_category(), "Cannot map "s + path);
+        }
+        try {
+            view_ = BinaryView<Type>(data_, size_);  // может бросить исключение
+        }
+        catch (...) {
+            munmap(data_, size_);
+            throw;
+        }
+    }
+
+    MappedBinaryFile(const MappedBinaryFile&) = delete;
+    MappedBinaryFile& operator=(const MappedBinaryFile&) = delete;
+
+    ~MappedBinaryFile() {
+        if (data_ != nullptr) {
+            munmap(data_, size_);
+        }
+    }
+
+    const BinaryView<Type>& View() const noexcept {
+        return view_;
+    }
+
+private:
+    void* data_ = nullptr;
+    size_t size_ = 0;
+    BinaryView<Type> view_;
+};
+#endif
+
+// Вектор с копированием при записи (copy-on-write).
+// Копии разделяют один буфер с атомарным счётчиком ссылок, поэтому копирование выполняется за O(1).
+// Перед первым изменением разделяемого буфера вектор получает собственную копию элементов.
+// Константные операции никогда не копируют данные, поэтому снимок можно читать из других потоков,
+// пока исходный вектор изменяется.
+// Неконстантные ссылки и итераторы, выданные вектором, остаются у вызывающего, поэтому буфер после этого
+// помечается неразделяемым (как в реализациях std::string с копированием при записи):
+// следующая копия сразу получает собственные элементы, и запись по старой ссылке не меняет снимок
+template <typename Type>
+class CowVector {
+    struct SharedItems {
+        template <typename... Args>
+        explicit SharedItems(Args&&... args)
+            : items(std::forward<Args>(args)...) {
+        }
+
+        std::atomic<size_t> ref_count = 1;
+        // Владелец выдал неконстантную ссылку на элементы. Флаг меняет только единственный владелец буфера
+        bool unshareable = false;
+        SimpleVector<Type> items;
+    };
+
+public:
+    using Iterator = Type*;
+    using ConstIterator = const Type*;
+
+    CowVector() noexcept = default;
+
+    // Создаёт вектор из size элементов, инициализированных значением по умолчанию
+    explicit CowVector(size_t size)
+        : shared_(new SharedItems(size)) {
+    }
+
+    // Создаёт вектор из size элементов, инициализированных значением value
+    CowVector(size_t size, const Type& value)
+        : shared_(new SharedItems(size, value)) {
+    }
+
+    // Создаёт вектор из initializer_list
+    CowVector(std::initializer_list<Type> init)
+        : shared_(new SharedItems(init)) {
+    }
+
+    // Забирает элементы вектора items без копирования
+    explicit CowVector(SimpleVector<Type>&& items)
+        : shared_(new SharedItems(std::move(items))) {
+    }
+
+    // Разделяет буфер с other за O(1). Неразделяемый буфер копируется
+    CowVector(const CowVector& other) {
+        if (other.shared_ == nullptr) {
+            return;
+        }
+        if (other.shared_->unshareable) {
+            shared_ = new SharedItems(other.shared_->items);  // может бросить исключение
+        }
+        else {
+            shared_ = other.shared_;
+            shared_->ref_count.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    CowVector(CowVector&& other) noexcept
+        : shared_(std::exchange(other.shared_, nullptr)) {
+    }
+
+    CowVector& operator=(const CowVector& rhs) {
+        if (&rhs != this) {
+            CowVector rhs_copy(rhs);  // может бросить исключение
+            swap(rhs_copy);
+        }
+        return *this;
+    }
+
+    CowVector& operator=(CowVector&& rhs) noexcept {
+        if (&rhs != this) {
+            CowVector rhs_moved(std::move(rhs));
+            swap(rhs_moved);
+        }
+        return *this;
+    }
+
+    ~CowVector() {
+        Release();
+    }
+
+    // Возвращает количество элементов в массиве
+    size_t GetSize() const noexcept {
+        return shared_ != nullptr ? shared_->items.GetSize() : 0;
+    }
+
+    // Возвращает вместимость массива
+    size_t GetCapacity() const noexcept {
+        return shared_ != nullptr ? shared_->items.GetCapacity() : 0;
+    }
+
+    // Сообщает, пустой ли массив
+    bool IsEmpty() const noexcept {
+        return GetSize() == 0;
+    }
+
+    // Сообщает, разделяет ли вектор буфер с другими копиями
+    bool IsShared() const noexcept {
+        return shared_ != nullptr && shared_->ref_count.load(std::memory_order_acquire) > 1;
+    }
+
+    // Возвращает константную ссылку на элемент с индексом index, не копируя буфер
+    const Type& operator[](size_t index) const noexcept {
+        assert(index < GetSize());
+        return shared_->items[index];
+    }
+
+    // Возвращает ссылку на элемент с индексом index.
+    // Если буфер разделяется с другими копиями, сначала создаёт собственную копию
+    Type& operator[](size_t index) {
+        assert(index < GetSize());
+        return MutableUnshareable()[index];  // может бросить исключение
+    }
+
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    const Type& At(size_t index) const {
+        if (index >= GetSize()) {
+            throw out_of_range("Item index is out of range"s);
+        }
+        return shared_->items[index];
+    }
+
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    Type& At(size_t index) {
+        if (index >= GetSize()) {
+            throw out_of_range("Item index is out of range"s);
+        }
+        return MutableUnshareable()[index];  // может бросить исключение
+    }
+
+    // Очищает вектор. Разделяемый буфер не копируется, а просто отпускается.
+    // Выданные ранее ссылки ведут на разрушенные элементы, поэтому буфер снова можно разделять
+    void Clear() noexcept {
+        if (IsShared()) {
+            Release();
+        }
+        else if (shared_ != nullptr) {
+            shared_->items.Clear();
+            shared_->unshareable = false;
+        }
+    }
+
+    void Reserve(size_t new_capacity) {
+        Mutable().Reserve(new_capacity);  // может бросить исключение
+    }
+
+    void Resize(size_t new_size) {
+        Mutable().Resize(new_size);  // может бросить исключение
+    }
+
+    void PushBack(Type item) {
+        Mutable().PushBack(std::move(item));  // может бросить исключение
+    }
+
+    template <typename... Args>
+    Type& EmplaceBack(Args&&... args) {
+        return MutableUnshareable().EmplaceBack(std::forward<Args>(args)...);  // может бросить исключение
+    }
+
+    // Итератор pos может указывать в разделяемый буфер: он пересчитывается в буфер собственной копии
+    Iterator Insert(ConstIterator pos, Type value) {
+        const size_t offset = pos - cbegin();
+        SimpleVector<Type>& items = MutableUnshareable();  // может бросить исключение
+        items.Insert(items.begin() + offset, std::move(value));  // может бросить исключение
+        return items.Data() + offset;
+    }
+
+    void PopBack() {
+        assert(!IsEmpty());
+        Mutable().PopBack();  // может бросить исключение
+    }
+
+    // Итератор pos может указывать в разделяемый буфер: он пересчитывается в буфер собственной копии
+    Iterator Erase(ConstIterator pos) {
+        const size_t offset = pos - cbegin();
+        SimpleVector<Type>& items = MutableUnshareable();  // может бросить исключение
+        items.Erase(items.begin() + offset);  // может бросить исключение
+        return items.Data() + offset;
+    }
+
+    void swap(CowVector& other) noexcept {
+        std::swap(shared_, other.shared_);
+    }
+
+    // Неконстантные итераторы позволяют изменять элементы, поэтому отделяют собственную копию
+    Iterator begin() {
+        return IsEmpty() ? nullptr : MutableUnshareable().Data();
+    }
+
+    Iterator end() {
+        return IsEmpty() ? nullptr : MutableUnshareable().Data() + GetSize();
+    }
+
+    ConstIterator begin() const noexcept {
+        return shared_ != nullptr ? shared_->items.Data() : nullptr;
+    }
+
+    ConstIterator end() const noexcept {
+        return shared_ != nullptr ? shared_->items.Data() + GetSize() : nullptr;
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return begin();
+    }
+
+    ConstIterator cend() const noexcept {
+        return end();
+    }
+
+private:
+    // Возвращает вектор, принадлежащий только этой копии, при необходимости копируя разделяемый буфер
+    SimpleVector<Type>& Mutable() {
+        if (shared_ == nullptr) {
+            shared_ = new SharedItems();
+        }
+        else if (IsShared()) {
+            auto* own = new SharedItems(shared_->items);  // может бросить исключение
+            Release();
+            shared_ = own;
+        }
+        return shared_->items;
+    }
+
+    // Возвращает собственный вектор для выдачи неконстантных ссылок на элементы и запрещает разделять его буфер
+    SimpleVector<Type>& MutableUnshareable() {
+        SimpleVector<Type>& items = Mutable();  // может бросить исключение
+        shared_->unshareable = true;
+        return items;
+    }
+
+    void Release() noexcept {
+        if (shared_ != nullptr && shared_->ref_count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete shared_;
+        }
+        shared_ = nullptr;
+    }
+
+    SharedItems* shared_ = nullptr;
+};
+
+template <typename Type>
+inline bool operator==(const CowVector<Type>& lhs, const CowVector<Type>& rhs) {
+    return (lhs.GetSize() == rhs.GetSize())
+        && RangeEqual(lhs.begin(), rhs.begin(), lhs.GetSize());  // может бросить исключение
+}
+
+template <typename Type>
+inline bool operator!=(const CowVector<Type>& lhs, const CowVector<Type>& rhs) {
+    return !(lhs == rhs);  // может бросить исключение
+}
+
+template <typename Type>
+inline bool operator<(const CowVector<Type>& lhs, const CowVector<Type>& rhs) {
+    return RangeLess(lhs.begin(), lhs.GetSize(), rhs.begin(), rhs.GetSize());  // может бросить исключение
+}
+
+template <typename Type>
+inline bool operator<=(const CowVector<Type>& lhs, const CowVector<Type>& rhs) {
+    return !(rhs < lhs);  // может бросить исключение
+}
+
+template <typename Type>
+inline bool operator>(const CowVector<Type>& lhs, const CowVector<Type>& rhs) {
+    return rhs < lhs;  // может бросить исключение
+}
+
+template <typename Type>
+inline bool operator>=(const CowVector<Type>& lhs, const CowVector<Type>& rhs) {
+    return rhs <= lhs;  // может бросить исключение
+}
+
+// Возвращает номер старшего установленного бита ненулевого значения value
+inline size_t HighestBitIndex(size_t value) noexcept {
+    assert(value != 0);
+#if defined(__GNUC__) || defined(__clang__)
+    return std::numeric_limits<unsigned long long>::digits - 1 - __builtin_clzll(value);
+#else
+    size_t index = 0;
+    while (value >>= 1) {
+        ++index;
+    }
+    return index;
+#endif
+}
+
+// Возвращает номер младшего установленного бита ненулевого значения value
+inline size_t LowestBitIndex(size_t value) noexcept {
+    assert(value != 0);
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(value);
+#else
+    size_t index = 0;
+    while ((value & 1) == 0) {
+        value >>= 1;
+        ++index;
+    }
+    return index;
+#endif
+}
+
+// Сегментированный вектор со стабильными адресами элементов.
+// Элементы хранятся в блоках геометрически растущего размера FIRST_BLOCK_SIZE, 2 * FIRST_BLOCK_SIZE, 4 * FIRST_BLOCK_SIZE...
+// При росте выделяется очередной блок, а уже созданные элементы никогда не перемещаются,
+// поэтому указатели и ссылки на них остаются действительными до удаления самих элементов.
+// Блок и смещение элемента вычисляются по старшему биту индекса за O(1)
+template <typename Type>
+class SegmentedVector {
+    using BlockPtr = ArrayPtr<Type, true>;
+
+    static constexpr size_t FIRST_BLOCK_BITS = 3;
+    static constexpr size_t FIRST_BLOCK_SIZE = size_t(1) << FIRST_BLOCK_BITS;
+    static constexpr size_t MAX_BLOCKS = std::numeric_limits<size_t>::digits - FIRST_BLOCK_BITS;
+
+    template <bool IsConst>
+    class BasicIterator {
+        using Container = std::conditional_t<IsConst, const SegmentedVector, SegmentedVector>;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = Type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<IsConst, const Type*, Type*>;
+        using reference = std::conditional_t<IsConst, const Type&, Type&>;
+
+        BasicIterator() noexcept = default;
+
+        BasicIterator(Container* items, size_t index) noexcept
+            : items_(items)
+            , index_(index) {
+            Seek();
+        }
+
+        // Неконстантный итератор неявно преобразуется в константный
+        template <bool OtherIsConst, typename = std::enable_if_t<IsConst && !OtherIsConst>>
+        BasicIterator(const BasicIterator<OtherIsConst>& other) noexcept
+            : items_(other.items_)
+            , index_(other.index_)
+            , ptr_(other.ptr_)
+            , block_end_(other.block_end_) {
+        }
+
+        reference operator*() const noexcept {
+            assert(ptr_ != nullptr);
+            return *ptr_;
+        }
+
+        pointer operator->() const noexcept {
+            assert(ptr_ != nullptr);
+            return ptr_;
+        }
+
+        reference operator[](difference_type offset) const noexcept {
+            return (*items_)[index_ + offset];
+        }
+
+        // Внутри блока итератор просто сдвигает указатель,
+        // поэтому последовательный обход не вычисляет положение каждого элемента заново
+        BasicIterator& operator++() noexcept {
+            if (++index_ == block_end_) {
+                Seek();
+            }
+            else {
+                ++ptr_;
+            }
+            return *this;
+        }
+
+        BasicIterator operator++(int) noexcept {
+            BasicIterator old(*this);
+            ++*this;
+            return old;
+        }
+
+        BasicIterator& operator--() noexcept {
+            --index_;
+            Seek();
+            return *this;
+        }
+
+        BasicIterator operator--(int) noexcept {
+            BasicIterator old(*this);
+            --*this;
+            return old;
+        }
+
+        BasicIterator& operator+=(difference_type offset) noexcept {
+            index_ += offset;
+            Seek();
+            return *this;
+        }
+
+        BasicIterator& operator-=(difference_type offset) noexcept {
+            index_ -= offset;
+            Seek();
+            return *this;
+        }
+
+        friend BasicIterator operator+(BasicIterator it, difference_type offset) noexcept {
+            return it += offset;
+        }
+
+        friend BasicIterator operator+(difference_type offset, BasicIterator it) noexcept {
+            return it += offset;
+        }
+
+        friend BasicIterator operator-(BasicIterator it, difference_type offset) noexcept {
+            return it -= offset;
+        }
+
+        friend difference_type operator-(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+        }
+
+        friend bool operator==(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ == rhs.index_;
+        }
+
+        friend bool operator!=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ != rhs.index_;
+        }
+
+        friend bool operator<(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ < rhs.index_;
+        }
+
+        friend bool operator<=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ <= rhs.index_;
+        }
+
+        friend bool operator>(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ > rhs.index_;
+        }
+
+        friend bool operator>=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ >= rhs.index_;
+        }
+
+    private:
+        friend class BasicIterator<!IsConst>;
+
+        // Находит элемент index_ и конец его блока.
+        // За пределами выделенных блоков указатель остаётся нулевым
+        void Seek() noexcept {
+            const size_t shifted = index_ + FIRST_BLOCK_SIZE;
+            const size_t high_bit = HighestBitIndex(shifted);
+            const size_t block = high_bit - FIRST_BLOCK_BITS;
+            block_end_ = (size_t(1) << (high_bit + 1)) - FIRST_BLOCK_SIZE;
+            ptr_ = block < items_->block_count_
+                ? items_->blocks_[block].Get() + (shifted ^ (size_t(1) << high_bit))
+                : nullptr;
+        }
+
+        Container* items_ = nullptr;
+        size_t index_ = 0;
+        pointer ptr_ = nullptr;
+        size_t block_end_ = 0;
+    };
+
+public:
+    using Iterator = BasicIterator<false>;
+    using ConstIterator = BasicIterator<true>;
+
+    SegmentedVector() noexcept = default;
+
+    // Создаёт вектор из size элементов, инициализированных значением по умолчанию
+    explicit SegmentedVector(size_t size) {
+        Resize(size);  // может бросить исключение
+    }
+
+    // Создаёт вектор из size элементов, инициализированных значением value
+    SegmentedVector(size_t size, const Type& value) {
+        Reserve(size);  // может бросить исключение
+        AppendOrRollback(size, [&value](SegmentedVector& items, size_t) {
+            items.EmplaceBack(value);  // может бросить исключение
+        });
+    }
+
+    // Создаёт вектор из initializer_list
+    SegmentedVector(std::initializer_list<Type> init) {
+        Reserve(init.size());  // может бросить исключение
+        AppendOrRollback(init.size(), [&init](SegmentedVector& items, size_t i) {
+            items.EmplaceBack(*(init.begin() + i));  // может бросить исключение
+        });
+    }
+
+    SegmentedVector(const SegmentedVector& other) {
+        Reserve(other.size_);  // может бросить исключение
+        AppendOrRollback(other.size_, [&other](SegmentedVector& items, size_t i) {
+            items.EmplaceBack(other[i]);  // может бросить исключение
+        });
+    }
+
+    // Перемещение забирает блоки other без перемещения элементов
+    SegmentedVector(SegmentedVector&& other) noexcept {
+        swap(other);
+    }
+
+    SegmentedVector& operator=(const SegmentedVector& rhs) {
+        if (&rhs != this) {
+            SegmentedVector rhs_copy(rhs);  // может бросить исключение
+            swap(rhs_copy);
+        }
+        return *this;
+    }
+
+    SegmentedVector& operator=(SegmentedVector&& rhs) noexcept {
+        if (&rhs != this) {
+            SegmentedVector rhs_moved(std::move(rhs));
+            swap(rhs_moved);
+        }
+        return *this;
+    }
+
+    // Блоки освобождают только память: элементы разрушаются здесь
+    ~SegmentedVector() {
+        Truncate(0);
+    }
+
+    // Возвращает количество элементов в массиве
+    size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    // Возвращает вместимость всех выделенных блоков
+    size_t GetCapacity() const noexcept {
+        return CapacityOf(block_count_);
+    }
+
+    // Сообщает, пустой ли массив
+    bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    // Возвращает ссылку на элемент с индексом index
+    Type& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return *Locate(index);
+    }
+
+    // Возвращает константную ссылку на элемент с индексом index
+    const Type& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return *Locate(index);
+    }
+
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    Type& At(size_t index) {
+        if (index >= size_) {
+            throw out_of_range("Item index is out of range"s);
+        }
+        return *Locate(index);
+    }
+
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    const Type& At(size_t index) const {
+        if (index >= size_) {
+            throw out_of_range("Item index is out of range"s);
+        }
+        return *Locate(index);
+    }
+
+    // Разрушает все элементы, не освобождая блоки
+    void Clear() noexcept {
+        Truncate(0);
+    }
+
+    // Выделяет блоки, пока вместимость не станет не меньше new_capacity.
+    // Уже созданные элементы не перемещаются
+    void Reserve(size_t new_capacity) {
+        while (GetCapacity() < new_capacity) {
+            AddBlock();  // может бросить исключение
+        }
+    }
+
+    // Изменяет размер массива.
+    // При увеличении размера новые элементы получают значение по умолчанию для типа Type.
+    // Если конструктор элемента выбросил исключение, размер массива не изменяется
+    void Resize(size_t new_size) {
+        if (new_size <= size_) {
+            Truncate(new_size);
+            return;
+        }
+        Reserve(new_size);  // может бросить исключение
+        AppendOrRollback(new_size - size_, [](SegmentedVector& items, size_t) {
+            items.EmplaceBack();  // может бросить исключение
+        });
+    }
+
+    // Добавляет элемент в конец вектора.
+    // Если вместимости не хватает, выделяется следующий блок, существующие элементы остаются на месте
+    void PushBack(Type item) {
+        EmplaceBack(std::move(item));  // может бросить исключение
+    }
+
+    // Создаёт элемент в конце вектора из аргументов args и возвращает ссылку на него
+    template <typename... Args>
+    Type& EmplaceBack(Args&&... args) {
+        if (size_ == GetCapacity()) {
+            AddBlock();  // может бросить исключение
+        }
+        Type* slot = Locate(size_);
+        new (slot) Type(std::forward<Args>(args)...);  // может бросить исключение
+        ++size_;
+        return *slot;
+    }
+
+    // "Удаляет" последний элемент вектора. Вектор не должен быть пустым
+    void PopBack() noexcept {
+        assert(size_ > 0);
+        Truncate(size_ - 1);
+    }
+
+    void swap(SegmentedVector& other) noexcept {
+        for (size_t i = 0; i < MAX_BLOCKS; ++i) {
+            blocks_[i].swap(other.blocks_[i]);
+        }
+        std::swap(block_count_, other.block_count_);
+        std::swap(size_, other.size_);
+    }
+
+    Iterator begin() noexcept {
+        return Iterator(this, 0);
+    }
+
+    Iterator end() noexcept {
+        return Iterator(this, size_);
+    }
+
+    ConstIterator begin() const noexcept {
+        return ConstIterator(this, 0);
+    }
+
+    ConstIterator end() const noexcept {
+        return ConstIterator(this, size_);
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return begin();
+    }
+
+    ConstIterator cend() const noexcept {
+        return end();
+    }
+
+private:
+    // Суммарная вместимость первых block_count блоков
+    static constexpr size_t CapacityOf(size_t block_count) noexcept {
+        return FIRST_BLOCK_SIZE * ((size_t(1) << block_count) - 1);
+    }
+
+    // Блок b начинается с индекса CapacityOf(b), поэтому для index + FIRST_BLOCK_SIZE
+    // старший бит задаёт номер блока, а остальные биты - смещение внутри него
+    Type* Locate(size_t index) const noexcept {
+        const size_t shifted = index + FIRST_BLOCK_SIZE;
+        const size_t high_bit = HighestBitIndex(shifted);
+        return blocks_[high_bit - FIRST_BLOCK_BITS].Get() + (shifted ^ (size_t(1) << high_bit));
+    }
+
+    void AddBlock() {
+        if (block_count_ == MAX_BLOCKS) {
+            throw length_error("SegmentedVector is too large"s);
+        }
+        blocks_[block_count_] = BlockPtr(FIRST_BLOCK_SIZE << block_count_);  // может бросить исключение
+        ++block_count_;
+    }
+
+    // Разрушает элементы с индексами из [new_size, size_)
+    void Truncate(size_t new_size) noexcept {
+        while (size_ > new_size) {
+            --size_;
+            std::destroy_at(Locate(size_));
+        }
+    }
+
+    // Добавляет count элементов функцией append.
+    // Если она выбросила исключение, добавленные элементы разрушаются, и исключение передаётся дальше
+    template <typename Append>
+    void AppendOrRollback(size_t count, Append append) {
+        const size_t old_size = size_;
+        try {
+            for (size_t i = 0; i < count; ++i) {
+                append(*this, i);  // может бросить исключение
+            }
+        }
+        catch (...) {
+            Truncate(old_size);
+            throw;
+        }
+    }
+
+    std::array<BlockPtr, MAX_BLOCKS> blocks_;
+    size_t block_count_ = 0;
+    size_t size_ = 0;
+};
+
+template <typename Type>
+inline bool operator==(const SegmentedVector<Type>& lhs, const SegmentedVector<Type>& rhs) {
+    return (lhs.GetSize() == rhs.GetSize()) && std::equal(lhs.begin(), lhs.end(), rhs.begin());  // может бросить исключение
+}
+
+template <typename Type>
+inline bool operator!=(const SegmentedVector<Type>& lhs, const SegmentedVector<Type>& rhs) {
+    return !(lhs == rhs);  // может бросить исключение
+}
+
+template <typename Type>
+inline bool operator<(const SegmentedVector<Type>& lhs, const SegmentedVector<Type>& rhs) {
+    return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());  // может бросить исключение
+}
+
+template <typename Type>
+inline bool operator<=(const SegmentedVector<Type>& lhs, const SegmentedVector<Type>& rhs) {
+    return !(rhs < lhs);  // может бросить исключение
+}
+
+template <typename Type>
+inline bool operator>(const SegmentedVector<Type>& lhs, const SegmentedVector<Type>& rhs) {
+    return rhs < lhs;  // может бросить исключение
+}
+
+template <typename Type>
+inline bool operator>=(const SegmentedVector<Type>& lhs, const SegmentedVector<Type>& rhs) {
+    return rhs <= lhs;  // может бросить исключение
+}
+
+// Вектор записей, хранящий каждое поле в отдельном столбце (structure of arrays).
+// Все столбцы имеют общие размер и вместимость, поэтому просмотр одного поля читает только его память.
+// Строка представлена кортежем ссылок на поля, что позволяет использовать структурные привязки:
+//     auto [id, price] = items[i];
+// Вместимость столбцов растёт согласно GrowthPolicy. Пакет полей не допускает параметра по умолчанию после себя,
+// поэтому политика задаётся первым параметром BasicSoAVector, а SoAVector использует DoublingGrowth
+template <typename GrowthPolicy, typename... Fields>
+class BasicSoAVector {
+    static_assert(sizeof...(Fields) > 0, "SoAVector requires at least one field");
+
+    using Columns = std::tuple<ArrayPtr<Fields, true>...>;
+    using FieldIndices = std::index_sequence_for<Fields...>;
+
+    template <size_t I>
+    using FieldType = std::tuple_element_t<I, std::tuple<Fields...>>;
+
+    // Перенос столбца не бросает исключений, если его поле переносится побайтово либо небросающим перемещением
+    template <size_t I>
+    static constexpr bool NOTHROW_RELOCATE_COLUMN = IsTriviallyRelocatableV<FieldType<I>> || std::is_nothrow_move_constructible_v<FieldType<I>>;
+
+    static constexpr bool NOTHROW_RELOCATE = ((IsTriviallyRelocatableV<Fields> || std::is_nothrow_move_constructible_v<Fields>) && ...);
+
+    template <bool IsConst>
+    class BasicIterator {
+        using Container = std::conditional_t<IsConst, const BasicSoAVector, BasicSoAVector>;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = std::tuple<Fields...>;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<IsConst, std::tuple<const Fields&...>, std::tuple<Fields&...>>;
+        using pointer = void;
+
+        BasicIterator() noexcept = default;
+
+        BasicIterator(Container* items, size_t index) noexcept
+            : items_(items)
+            , index_(index) {
+        }
+
+        // Неконстантный итератор неявно преобразуется в константный
+        template <bool OtherIsConst, typename = std::enable_if_t<IsConst && !OtherIsConst>>
+        BasicIterator(const BasicIterator<OtherIsConst>& other) noexcept
+            : items_(other.items_)
+            , index_(other.index_) {
+        }
+
+        reference operator*() const noexcept {
+            return (*items_)[index_];
+        }
+
+        reference operator[](difference_type offset) const noexcept {
+            return (*items_)[index_ + offset];
+        }
+
+        BasicIterator& operator++() noexcept {
+            ++index_;
+            return *this;
+        }
+
+        BasicIterator operator++(int) noexcept {
+            BasicIterator old(*this);
+            ++index_;
+            return old;
+        }
+
+        BasicIterator& operator--() noexcept {
+            --index_;
+            return *this;
+        }
+
+        BasicIterator operator--(int) noexcept {
+            BasicIterator old(*this);
+            --index_;
+            return old;
+        }
+
+        BasicIterator& operator+=(difference_type offset) noexcept {
+            index_ += offset;
+            return *this;
+        }
+
+        BasicIterator& operator-=(difference_type offset) noexcept {
+            index_ -= offset;
+            return *this;
+        }
+
+        friend BasicIterator operator+(BasicIterator it, difference_type offset) noexcept {
+            return it += offset;
+        }
+
+        friend BasicIterator operator+(difference_type offset, BasicIterator it) noexcept {
+            return it += offset;
+        }
+
+        friend BasicIterator operator-(BasicIterator it, difference_type offset) noexcept {
+            return it -= offset;
+        }
+
+        friend difference_type operator-(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+        }
+
+        friend bool operator==(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ == rhs.index_;
+        }
+
+        friend bool operator!=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ != rhs.index_;
+        }
+
+        friend bool operator<(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ < rhs.index_;
+        }
+
+        friend bool operator<=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ <= rhs.index_;
+        }
+
+        friend bool operator>(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ > rhs.index_;
+        }
+
+        friend bool operator>=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ >= rhs.index_;
+        }
+
+    private:
+        friend class BasicSoAVector;
+        friend class BasicIterator<!IsConst>;
+
+        Container* items_ = nullptr;
+        size_t index_ = 0;
+    };
+
+public:
+    using Row = std::tuple<Fields&...>;
+    using ConstRow = std::tuple<const Fields&...>;
+    using Iterator = BasicIterator<false>;
+    using ConstIterator = BasicIterator<true>;
+
+    BasicSoAVector() noexcept = default;
+
+    // Создаёт вектор из size строк, поля которых инициализированы значением по умолчанию
+    explicit BasicSoAVector(size_t size) {
+        Resize(size);  // может бросить исключение
+    }
+
+    BasicSoAVector(const BasicSoAVector& other) {
+        Reserve(other.size_);  // может бросить исключение
+        try {
+            for (; size_ < other.size_; ++size_) {
+                ConstructRow(size_, other[size_], FieldIndices{});  // может бросить исключение
+            }
+        }
+        catch (...) {
+            Truncate(0);
+            throw;
+        }
+    }
+
+    BasicSoAVector(BasicSoAVector&& other) noexcept {
+        swap(other);
+    }
+
+    BasicSoAVector& operator=(const BasicSoAVector& rhs) {
+        if (&rhs != this) {
+            BasicSoAVector rhs_copy(rhs);  // может бросить исключение
+            swap(rhs_copy);
+        }
+        return *this;
+    }
+
+    BasicSoAVector& operator=(BasicSoAVector&& rhs) noexcept {
+        if (&rhs != this) {
+            BasicSoAVector rhs_moved(std::move(rhs));
+            swap(rhs_moved);
+        }
+        return *this;
+    }
+
+    // Столбцы освобождают только память: поля разрушаются здесь
+    ~BasicSoAVector() {
+        Truncate(0);
+    }
+
+    // Возвращает количество строк
+    size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    // Возвращает общую вместимость столбцов
+    size_t GetCapacity() const noexcept {
+        return std::get<0>(columns_).GetSize();
+    }
+
+    // Сообщает, пустой ли массив
+    bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    // Возвращает строку с индексом index как кортеж ссылок на её поля
+    Row operator[](size_t index) noexcept {
+        assert(index < size_);
+        return RowAt(index, FieldIndices{});
+    }
+
+    ConstRow operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return RowAt(index, FieldIndices{});
+    }
+
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    Row At(size_t index) {
+        if (index >= size_) {
+            throw out_of_range("Item index is out of range"s);
+        }
+        return RowAt(index, FieldIndices{});
+    }
+
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    ConstRow At(size_t index) const {
+        if (index >= size_) {
+            throw out_of_range("Item index is out of range"s);
+        }
+        return RowAt(index, FieldIndices{});
+    }
+
+    // Возвращает ссылку на поле I строки index
+    template <size_t I>
+    FieldType<I>& Get(size_t index) noexcept {
+        assert(index < size_);
+        return std::get<I>(columns_)[index];
+    }
+
+    template <size_t I>
+    const FieldType<I>& Get(size_t index) const noexcept {
+        assert(index < size_);
+        return std::get<I>(columns_)[index];
+    }
+
+    // Возвращает непрерывный столбец поля I
+    template <size_t I>
+    Span<FieldType<I>> Column() noexcept {
+        return { std::get<I>(columns_).Get(), size_ };
+    }
+
+    template <size_t I>
+    Span<const FieldType<I>> Column() const noexcept {
+        return { std::get<I>(columns_).Get(), size_ };
+    }
+
+    // Разрушает все строки, не освобождая память
+    void Clear() noexcept {
+        Truncate(0);
+    }
+
+    // Увеличивает вместимость всех столбцов до new_capacity.
+    // Если перенос поля выбросил исключение, вектор остаётся в исходном состоянии. Исключение составляют поля
+    // без конструктора копирования с бросающим перемещением: для них, как и в std::vector, гарантия только базовая
+    void Reserve(size_t new_capacity) {
+        if (new_capacity > GetCapacity()) {
+            Reallocate(new_capacity, FieldIndices{});  // может бросить исключение
+        }
+    }
+
+    // Изменяет количество строк.
+    // Новые строки получают значения полей по умолчанию.
+    // Если конструктор поля выбросил исключение, размер не изменяется
+    void Resize(size_t new_size) {
+        if (new_size <= size_) {
+            Truncate(new_size);
+            return;
+        }
+        Reserve(new_size);  // может бросить исключение
+        const size_t old_size = size_;
+        try {
+            for (; size_ < new_size; ++size_) {
+                ConstructRow(size_, std::tuple<>(), FieldIndices{});  // может бросить исключение
+            }
+        }
+        catch (...) {
+            Truncate(old_size);
+            throw;
+        }
+    }
+
+    // Добавляет строку в конец вектора.
+    // Если конструктор поля выбросил исключение, вектор не изменяется
+    void PushBack(Fields... values) {
+        if (size_ == GetCapacity()) {
+            Reserve(std::max(GrowthPolicy::NextCapacity(GetCapacity()), size_ + 1));  // может бросить исключение
+        }
+        ConstructRow(size_, std::forward_as_tuple(std::move(values)...), FieldIndices{});  // может бросить исключение
+        ++size_;
+    }
+
+    // "Удаляет" последнюю строку. Вектор не должен быть пустым
+    void PopBack() noexcept {
+        assert(size_ > 0);
+        Truncate(size_ - 1);
+    }
+
+    // Удаляет строку в позиции pos, сдвигая последующие строки в каждом столбце.
+    // Возвращает итератор на строку, следующую за удалённой
+    Iterator Erase(ConstIterator pos) {
+        assert(pos.index_ < size_);
+        EraseRow(pos.index_, FieldIndices{});  // может бросить исключение
+        Truncate(size_ - 1);
+        return Iterator(this, pos.index_);
+    }
+
+    void swap(BasicSoAVector& other) noexcept {
+        SwapColumns(other.columns_, FieldIndices{});
+        std::swap(size_, other.size_);
+    }
+
+    Iterator begin() noexcept {
+        return Iterator(this, 0);
+    }
+
+    Iterator end() noexcept {
+        return Iterator(this, size_);
+    }
+
+    ConstIterator begin() const noexcept {
+        return ConstIterator(this, 0);
+    }
+
+    ConstIterator end() const noexcept {
+        return ConstIterator(this, size_);
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return begin();
+    }
+
+    ConstIterator cend() const noexcept {
+        return end();
+    }
+
+private:
+    template <size_t... I>
+    Row RowAt(size_t index, std::index_sequence<I...>) noexcept {
+        return Row(std::get<I>(columns_)[index]...);
+    }
+
+    template <size_t... I>
+    ConstRow RowAt(size_t index, std::index_sequence<I...>) const noexcept {
+        return ConstRow(std::get<I>(columns_)[index]...);
+    }
+
+    // Создаёт поле I строки index из I-го элемента кортежа args либо по умолчанию, если кортеж пуст
+    template <size_t I, typename Args>
+    void ConstructField(size_t index, Args&& args) {
+        FieldType<I>* slot = std::get<I>(columns_).Get() + index;
+        if constexpr (std::tuple_size_v<std::decay_t<Args>> == 0) {
+            new (slot) FieldType<I>();  // может бросить исключение
+        }
+        else {
+            new (slot) FieldType<I>(std::get<I>(std::forward<Args>(args)));  // может бросить исключение
+        }
+    }
+
+    // Создаёт все поля строки index по порядку.
+    // Если конструктор поля выбросил исключение, уже созданные поля строки разрушаются
+    template <typename Args, size_t... I>
+    void ConstructRow(size_t index, Args&& args, std::index_sequence<I...>) {
+        size_t constructed = 0;
+        try {
+            ((ConstructField<I>(index, std::forward<Args>(args)), ++constructed), ...);  // может бросить исключение
+        }
+        catch (...) {
+            ((I < constructed ? std::destroy_at(std::get<I>(columns_).Get() + index) : void()), ...);
+            throw;
+        }
+    }
+
+    template <size_t... I>
+    void EraseRow(size_t index, std::index_sequence<I...>) {
+        (std::move(std::get<I>(columns_).Get() + index + 1, std::get<I>(columns_).Get() + size_,
+            std::get<I>(columns_).Get() + index), ...);  // может бросить исключение
+    }
+
+    // Разрушает строки с индексами из [new_size, size_)
+    void Truncate(size_t new_size) noexcept {
+        if (new_size < size_) {
+            DestroyRows(new_size, size_, FieldIndices{});
+            size_ = new_size;
+        }
+    }
+
+    template <size_t... I>
+    void DestroyRows(size_t first, size_t last, std::index_sequence<I...>) noexcept {
+        (DestroyRange(std::get<I>(columns_).GetAllocator(), std::get<I>(columns_).Get() + first,
+            std::get<I>(columns_).Get() + last), ...);
+    }
+
+    // Переносит столбец I в память new_column, если его поля переносятся без исключений
+    template <size_t I>
+    void RelocateColumn(ArrayPtr<FieldType<I>, true>& new_column) noexcept {
+        if constexpr (NOTHROW_RELOCATE_COLUMN<I>) {
+            auto& column = std::get<I>(columns_);
+            UninitializedRelocate(column.GetAllocator(), column.Get(), column.Get() + size_, new_column.Get());
+        }
+    }
+
+    // Заполняет new_column полями столбца I, перенос которых может бросить исключение.
+    // Поля копируются, и исходный столбец не изменяется; поля без конструктора копирования перемещаются
+    template <size_t I>
+    void TransferColumn(ArrayPtr<FieldType<I>, true>& new_column) {
+        if constexpr (!NOTHROW_RELOCATE_COLUMN<I>) {
+            auto& column = std::get<I>(columns_);
+            FieldType<I>* first = column.Get();
+            if constexpr (std::is_copy_constructible_v<FieldType<I>>) {
+                UninitializedCopy(column.GetAllocator(), first, first + size_, new_column.Get());  // может бросить исключение
+            }
+            else {
+                UninitializedMove(column.GetAllocator(), first, first + size_, new_column.Get());  // может бросить исключение
+            }
+        }
+    }
+
+    // Разрушает поля столбца I, заполненного через TransferColumn
+    template <size_t I>
+    void DestroyTransferred(ArrayPtr<FieldType<I>, true>& column) noexcept {
+        if constexpr (!NOTHROW_RELOCATE_COLUMN<I>) {
+            DestroyRange(column.GetAllocator(), column.Get(), column.Get() + size_);
+        }
+    }
+
+    // Выделяет столбцы вместимостью new_capacity и переносит в них строки.
+    // Сначала заполняются столбцы, перенос которых может бросить исключение, и только после этого
+    // разрушаются их старые копии и переносятся остальные столбцы. Так исключение в любом столбце
+    // застаёт столбцы, переносимые без исключений, нетронутыми, и вектор остаётся без изменений
+    template <size_t... I>
+    void Reallocate(size_t new_capacity, std::index_sequence<I...>) {
+        Columns new_columns(ArrayPtr<Fields, true>(new_capacity, std::get<I>(columns_).GetAllocator())...);  // может бросить исключение
+        if constexpr (!NOTHROW_RELOCATE) {
+            size_t transferred = 0;
+            try {
+                ((TransferColumn<I>(std::get<I>(new_columns)), ++transferred), ...);  // может бросить исключение
+            }
+            catch (...) {
+                ((I < transferred ? DestroyTransferred<I>(std::get<I>(new_columns)) : void()), ...);
+                throw;
+            }
+            (DestroyTransferred<I>(std::get<I>(columns_)), ...);
+        }
+        (RelocateColumn<I>(std::get<I>(new_columns)), ...);
+        SwapColumns(new_columns, std::index_sequence<I...>{});
+    }
+
+    template <size_t... I>
+    void SwapColumns(Columns& other, std::index_sequence<I...>) noexcept {
+        (std::get<I>(columns_).swap(std::get<I>(other)), ...);
+    }
+
+    Columns columns_;
+    size_t size_ = 0;
+};
+
+template <typename... Fields>
+using SoAVector = BasicSoAVector<DoublingGrowth, Fields...>;
+
+// Хранилище элементов InplaceVector.
+// Элементы тривиальных типов лежат в обычном массиве, поэтому вектор остаётся литеральным типом
+// и может использоваться в константных выражениях. В C++20 массив не инициализируется при создании вектора
+// и неиспользуемая вместимость ничего не стоит; ячейки заполняются значениями только в константных выражениях,
+// где нельзя копировать неинициализированные значения. constexpr-конструктор C++17 обязан инициализировать
+// все члены, поэтому там массив обнуляется
+template <typename Type, size_t N, bool IsTrivial = std::is_trivial_v<Type>>
+class InplaceStorage {
+protected:
+#ifdef __cpp_lib_is_constant_evaluated
+    constexpr InplaceStorage() noexcept {
+        if (IsConstantEvaluated()) {
+            for (Type& item : items_) {
+                item = Type();
+            }
+        }
+    }
+#endif
+
+    constexpr Type* Data() noexcept {
+        return items_;
+    }
+
+    constexpr const Type* Data() const noexcept {
+        return items_;
+    }
+
+    template <typename... Args>
+    constexpr void Construct(size_t index, Args&&... args) {
+        items_[index] = Type(std::forward<Args>(args)...);
+    }
+
+    constexpr void Destroy(size_t) noexcept {
+    }
+
+#ifdef __cpp_lib_is_constant_evaluated
+    Type items_[N];
+#else
+    Type items_[N] = {};
+#endif
+    size_t size_ = 0;
+};
+
+// Элементы остальных типов создаются в выровненном буфере внутри объекта
+template <typename Type, size_t N>
+class InplaceStorage<Type, N, false> {
+protected:
+    InplaceStorage() noexcept {
+    }
+
+    InplaceStorage(const InplaceStorage& other) {
+        std::uninitialized_copy_n(other.Data(), other.size_, Data());  // может бросить исключение
+        size_ = other.size_;
+    }
+
+    // Элементы other перемещаются поэлементно и остаются в other в перемещённом состоянии
+    InplaceStorage(InplaceStorage&& other) noexcept(std::is_nothrow_move_constructible_v<Type>) {
+        std::uninitialized_move_n(other.Data(), other.size_, Data());  // может бросить исключение
+        size_ = other.size_;
+    }
+
+    InplaceStorage& operator=(const InplaceStorage& rhs) {
+        if (&rhs != this) {
+            Assign(rhs.Data(), rhs.size_);  // может бросить исключение
+        }
+        return *this;
+    }
+
+    InplaceStorage& operator=(InplaceStorage&& rhs) noexcept(std::is_nothrow_move_constructible_v<Type>
+        && std::is_nothrow_move_assignable_v<Type>) {
+        if (&rhs != this) {
+            Assign(std::make_move_iterator(rhs.Data()), rhs.size_);  // может бросить исключение
+        }
+        return *this;
+    }
+
+    ~InplaceStorage() {
+        std::destroy_n(Data(), size_);
+    }
+
+    Type* Data() noexcept {
+        return reinterpret_cast<Type*>(items_);
+    }
+
+    const Type* Data() const noexcept {
+        return reinterpret_cast<const Type*>(items_);
+    }
+
+    template <typename... Args>
+    void Construct(size_t index, Args&&... args) {
+        new (Data() + index) Type(std::forward<Args>(args)...);  // может бросить исключение
+    }
+
+    void Destroy(size_t index) noexcept {
+        std::destroy_at(Data() + index);
+    }
+
+    alignas(Type) unsigned char items_[sizeof(Type) * N];
+    size_t size_ = 0;
+
+private:
+    // Присваивает count элементов из first общей части, создаёт недостающие и разрушает лишние
+    template <typename InputIt>
+    void Assign(InputIt first, size_t count) {
+        const size_t common = std::min(count, size_);
+        std::copy_n(first, common, Data());  // может бросить исключение
+        if (count > size_) {
+            std::uninitialized_copy_n(first + common, count - size_, Data() + size_);  // может бросить исключение
+        }
+        else {
+            std::destroy(Data() + count, Data() + size_);
+        }
+        size_ = count;
+    }
+};
+
+// Вектор фиксированной вместимости N, хранящий элементы внутри объекта и никогда не обращающийся к куче.
+// Переполнение можно обработать без исключений через TryPushBack и TryEmplaceBack,
+// а PushBack, Insert и Resize при переполнении выбрасывают std::length_error.
+// Для тривиальных типов все операции можно выполнять в константных выражениях
+template <typename Type, size_t N>
+class InplaceVector : private InplaceStorage<Type, N> {
+    static_assert(N > 0, "InplaceVector requires non-zero capacity");
+    using Storage = InplaceStorage<Type, N>;
+    using Storage::Data;
+    using Storage::Construct;
+    using Storage::Destroy;
+    using Storage::size_;
+
+public:
+    using Iterator = Type*;
+    using ConstIterator = const Type*;
+
+    constexpr InplaceVector() noexcept = default;
+
+    // Создаёт вектор из size элементов, инициализированных значением по умолчанию.
+    // Выбрасывает std::length_error, если size > N
+    constexpr explicit InplaceVector(size_t size) {
+        Resize(size);  // может бросить исключение
+    }
+
+    // Создаёт вектор из size элементов, инициализированных значением value
+    constexpr InplaceVector(size_t size, const Type& value) {
+        CheckCapacity(size);
+        for (; size_ < size; ++size_) {
+            Construct(size_, value);  // может бросить исключение
+        }
+    }
+
+    // Создаёт вектор из initializer_list
+    constexpr InplaceVector(std::initializer_list<Type> init) {
+        CheckCapacity(init.size());
+        for (const Type& item : init) {
+            Construct(size_, item);  // может бросить исключение
+            ++size_;
+        }
+    }
+
+    // Возвращает количество элементов в массиве
+    constexpr size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    // Возвращает вместимость массива
+    static constexpr size_t GetCapacity() noexcept {
+        return N;
+    }
+
+    // Сообщает, пустой ли массив
+    constexpr bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    // Сообщает, заполнен ли массив до вместимости
+    constexpr bool IsFull() const noexcept {
+        return size_ == N;
+    }
+
+    // Возвращает ссылку на элемент с индексом index
+    constexpr Type& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return Data()[index];
+    }
+
+    // Возвращает константную ссылку на элемент с индексом index
+    constexpr const Type& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return Data()[index];
+    }
+
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    constexpr Type& At(size_t index) {
+        if (index >= size_) {
+            throw out_of_range("Item index is out of range"s);
+        }
+        return Data()[index];
+    }
+
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    constexpr const Type& At(size_t index) const {
+        if (index >= size_) {
+            throw out_of_range("Item index is out of range"s);
+        }
+        return Data()[index];
+    }
+
+    // Обнуляет размер массива
+    constexpr void Clear() noexcept {
+        Truncate(0);
+    }
+
+    // Изменяет размер массива.
+    // При увеличении размера новые элементы получают значение по умолчанию для типа Type.
+    // Выбрасывает std::length_error, если new_size > N
+    constexpr void Resize(size_t new_size) {
+        CheckCapacity(new_size);
+        if (new_size <= size_) {
+            Truncate(new_size);
+        }
+        else if constexpr (std::is_trivial_v<Type>) {
+            for (; size_ < new_size; ++size_) {
+                Construct(size_);
+            }
+        }
+        else {
+            GrowWithRollback(new_size);  // может бросить исключение
+        }
+    }
+
+    // Добавляет элемент в конец вектора.
+    // Выбрасывает std::length_error, если вектор заполнен
+    constexpr void PushBack(Type item) {
+        EmplaceBack(std::move(item));  // может бросить исключение
+    }
+
+    // Добавляет элемент в конец вектора, если есть место.
+    // Возвращает false, не изменяя вектор и не выбрасывая исключений, если вектор заполнен
+    constexpr bool TryPushBack(Type item) noexcept(std::is_nothrow_move_constructible_v<Type>) {
+        return TryEmplaceBack(std::move(item)) != nullptr;
+    }
+
+    // Создаёт элемент в конце вектора из аргументов args и возвращает ссылку на него.
+    // Выбрасывает std::length_error, если вектор заполнен
+    template <typename... Args>
+    constexpr Type& EmplaceBack(Args&&... args) {
+        // Граница проверяется здесь же, а не в CheckCapacity, чтобы компилятор видел, что size_ < N
+        if (size_ == N) {
+            throw length_error("InplaceVector capacity exceeded"s);
+        }
+        return UncheckedEmplaceBack(std::forward<Args>(args)...);  // может бросить исключение
+    }
+
+    // Создаёт элемент в конце вектора, если есть место, и возвращает указатель на него.
+    // Если вектор заполнен, возвращает nullptr
+    template <typename... Args>
+    constexpr Type* TryEmplaceBack(Args&&... args) noexcept(std::is_nothrow_constructible_v<Type, Args&&...>) {
+        if (IsFull()) {
+            return nullptr;
+        }
+        return &UncheckedEmplaceBack(std::forward<Args>(args)...);  // может бросить исключение
+    }
+
+    // Вставляет значение value в позицию pos.
+    // Возвращает итератор на вставленное значение.
+    // Выбрасывает std::length_error, если вектор заполнен
+    constexpr Iterator Insert(ConstIterator pos, Type value) {
+        assert(pos >= cbegin() && pos <= cend());
+        if (size_ == N) {
+            throw length_error("InplaceVector capacity exceeded"s);
+        }
+        const size_t index = pos - cbegin();
+        if (index == size_) {
+            return &UncheckedEmplaceBack(std::move(value));  // может бросить исключение
+        }
+        Type* items = Data();
+        UncheckedEmplaceBack(std::move(items[size_ - 1]));  // может бросить исключение
+        for (size_t i = size_ - 2; i > index; --i) {
+            items[i] = std::move(items[i - 1]);  // может бросить исключение
+        }
+        items[index] = std::move(value);  // может бросить исключение
+        return items + index;
+    }
+
+    // Создаёт элемент из аргументов args в позиции pos
+    template <typename... Args>
+    constexpr Iterator Emplace(ConstIterator pos, Args&&... args) {
+        return Insert(pos, Type(std::forward<Args>(args)...));  // может бросить исключение
+    }
+
+    // "Удаляет" последний элемент вектора. Вектор не должен быть пустым
+    constexpr void PopBack() noexcept {
+        assert(size_ > 0);
+        Truncate(size_ - 1);
+    }
+
+    // Удаляет элемент вектора в указанной позиции
+    constexpr Iterator Erase(ConstIterator pos) {
+        assert(pos >= cbegin() && pos < cend());
+        const size_t index = pos - cbegin();
+        Type* items = Data();
+        for (size_t i = index + 1; i < size_; ++i) {
+            items[i - 1] = std::move(items[i]);  // может бросить исключение
+        }
+        Truncate(size_ - 1);
+        return items + index;
+    }
+
+    // Обменивается значением с другим вектором поэлементно
+    constexpr void swap(InplaceVector& other) noexcept(std::is_nothrow_move_constructible_v<Type>
+        && std::is_nothrow_swappable_v<Type>) {
+        InplaceVector& shorter = size_ < other.size_ ? *this : other;
+        InplaceVector& longer = size_ < other.size_ ? other : *this;
+        const size_t common = shorter.size_;
+        for (size_t i = 0; i < common; ++i) {
+            using std::swap;
+            swap(shorter.Data()[i], longer.Data()[i]);  // может бросить исключение
+        }
+        for (size_t i = common; i < longer.size_; ++i) {
+            shorter.UncheckedEmplaceBack(std::move(longer.Data()[i]));  // может бросить исключение
+        }
+        longer.Truncate(common);
+    }
+
+    constexpr Iterator begin() noexcept {
+        return Data();
+    }
+
+    constexpr Iterator end() noexcept {
+        return Data() + size_;
+    }
+
+    constexpr ConstIterator begin() const noexcept {
+        return Data();
+    }
+
+    constexpr ConstIterator end() const noexcept {
+        return Data() + size_;
+    }
+
+    constexpr ConstIterator cbegin() const noexcept {
+        return begin();
+    }
+
+    constexpr ConstIterator cend() const noexcept {
+        return end();
+    }
+
+private:
+    static constexpr void CheckCapacity(size_t size) {
+        if (size > N) {
+            throw length_error("InplaceVector capacity exceeded"s);
+        }
+    }
+
+    template <typename... Args>
+    constexpr Type& UncheckedEmplaceBack(Args&&... args) {
+        Construct(size_, std::forward<Args>(args)...);  // может бросить исключение
+        return Data()[size_++];
+    }
+
+    // Если конструктор элемента выбросил исключение, созданные элементы разрушаются и размер не изменяется.
+    // Блок try недопустим в constexpr-функциях C++17, поэтому откат вынесен из Resize
+    void GrowWithRollback(size_t new_size) {
+        const size_t old_size = size_;
+        try {
+            for (; size_ < new_size; ++size_) {
+                Construct(size_);  // может бросить исключение
+            }
+        }
+        catch (...) {
+            Truncate(old_size);
+            throw;
+        }
+    }
+
+    constexpr void Truncate(size_t new_size) noexcept {
+        while (size_ > new_size) {
+            Destroy(--size_);
+        }
+    }
+};
+
+template <typename Type, size_t N>
+constexpr bool operator==(const InplaceVector<Type, N>& lhs, const InplaceVector<Type, N>& rhs) {
+    return (lhs.GetSize() == rhs.GetSize())
+        && RangeEqual(lhs.begin(), rhs.begin(), lhs.GetSize());  // может бросить исключение
+}
+
+template <typename Type, size_t N>
+constexpr bool operator!=(const InplaceVector<Type, N>& lhs, const InplaceVector<Type, N>& rhs) {
+    return !(lhs == rhs);  // может бросить исключение
+}
+
+template <typename Type, size_t N>
+constexpr bool operator<(const InplaceVector<Type, N>& lhs, const InplaceVector<Type, N>& rhs) {
+    return RangeLess(lhs.begin(), lhs.GetSize(), rhs.begin(), rhs.GetSize());  // может бросить исключение
+}
+
+template <typename Type, size_t N>
+constexpr bool operator<=(const InplaceVector<Type, N>& lhs, const InplaceVector<Type, N>& rhs) {
+    return !(rhs < lhs);  // может бросить исключение
+}
+
+template <typename Type, size_t N>
+constexpr bool operator>(const InplaceVector<Type, N>& lhs, const InplaceVector<Type, N>& rhs) {
+    return rhs < lhs;  // может бросить исключение
+}
+
+template <typename Type, size_t N>
+constexpr bool operator>=(const InplaceVector<Type, N>& lhs, const InplaceVector<Type, N>& rhs) {
+    return rhs <= lhs;  // может бросить исключение
+}
+
+// Вектор только для добавления, в который могут одновременно писать несколько потоков.
+// Индекс нового элемента резервируется атомарным fetch_add, элементы хранятся в блоках
+// геометрически растущего размера (как в SegmentedVector) и никогда не перемещаются.
+// Элемент становится видимым читателям, когда опубликован весь префикс до него включительно:
+// GetSize() возвращает длину непрерывного префикса полностью созданных элементов,
+// поэтому элементы [0, GetSize()) можно читать из любого потока без блокировок.
+// Производитель только отмечает свою ячейку готовой, а границу префикса продвигают читатели в GetSize().
+// Блоки выделяются по требованию распределителем Allocator; Reserve заранее выделяет их,
+// чтобы добавление не обращалось к распределителю. Пустой распределитель хранится как базовый класс
+// AllocatorStorage и не увеличивает размер вектора
+template <typename Type, typename Allocator = std::allocator<Type>>
+class ConcurrentVector : private AllocatorStorage<Allocator> {
+    // Элемент создаётся до резервирования индекса и затем перемещается в ячейку:
+    // так исключение конструктора не оставляет в префиксе незаполненных ячеек
+    static_assert(std::is_nothrow_move_constructible_v<Type>, "ConcurrentVector requires nothrow move constructible type");
+
+    struct Slot {
+        Type* Get() noexcept {
+            return reinterpret_cast<Type*>(item);
+        }
+
+        alignas(Type) unsigned char item[sizeof(Type)];
+        std::atomic<bool> ready = false;
+    };
+
+    using SlotAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Slot>;
+    using BlockPtr = ArrayPtr<Slot, false, SlotAllocator>;
+    using Storage = AllocatorStorage<Allocator>;
+
+    static constexpr size_t FIRST_BLOCK_BITS = 5;
+    static constexpr size_t FIRST_BLOCK_SIZE = size_t(1) << FIRST_BLOCK_BITS;
+    static constexpr size_t MAX_BLOCKS = std::numeric_limits<size_t>::digits - FIRST_BLOCK_BITS;
+    static constexpr size_t MAX_ORPHANS = 64;
+
+public:
+    class ConstIterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = Type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Type*;
+        using reference = const Type&;
+
+        ConstIterator() noexcept = default;
+
+        ConstIterator(const ConcurrentVector* items, size_t index) noexcept
+            : items_(items)
+            , index_(index) {
+        }
+
+        reference operator*() const noexcept {
+            return (*items_)[index_];
+        }
+
+        pointer operator->() const noexcept {
+            return &(*items_)[index_];
+        }
+
+        reference operator[](difference_type offset) const noexcept {
+            return (*items_)[index_ + offset];
+        }
+
+        ConstIterator& operator++() noexcept {
+            ++index_;
+            return *this;
+        }
+
+        ConstIterator operator++(int) noexcept {
+            ConstIterator old(*this);
+            ++index_;
+            return old;
+        }
+
+        ConstIterator& operator--() noexcept {
+            --index_;
+            return *this;
+        }
+
+        ConstIterator operator--(int) noexcept {
+            ConstIterator old(*this);
+            --index_;
+            return old;
+        }
+
+        ConstIterator& operator+=(difference_type offset) noexcept {
+            index_ += offset;
+            return *this;
+        }
+
+        ConstIterator& operator-=(difference_type offset) noexcept {
+            index_ -= offset;
+            return *this;
+        }
+
+        friend ConstIterator operator+(ConstIterator it, difference_type offset) noexcept {
+            return it += offset;
+        }
+
+        friend ConstIterator operator+(difference_type offset, ConstIterator it) noexcept {
+            return it += offset;
+        }
+
+        friend ConstIterator operator-(ConstIterator it, difference_type offset) noexcept {
+            return it -= offset;
+        }
+
+        friend difference_type operator-(const ConstIterator& lhs, const ConstIterator& rhs) noexcept {
+            return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+        }
+
+        friend bool operator==(const ConstIterator& lhs, const ConstIterator& rhs) noexcept {
+            return lhs.index_ == rhs.index_;
+        }
+
+        friend bool operator!=(const ConstIterator& lhs, const ConstIterator& rhs) noexcept {
+            return lhs.index_ != rhs.index_;
+        }
+
+        friend bool operator<(const ConstIterator& lhs, const ConstIterator& rhs) noexcept {
+            return lhs.index_ < rhs.index_;
+        }
+
+        friend bool operator<=(const ConstIterator& lhs, const ConstIterator& rhs) noexcept {
+            return lhs.index_ <= rhs.index_;
+        }
+
+        friend bool operator>(const ConstIterator& lhs, const ConstIterator& rhs) noexcept {
+            return lhs.index_ > rhs.index_;
+        }
+
+        friend bool operator>=(const ConstIterator& lhs, const ConstIterator& rhs) noexcept {
+            return lhs.index_ >= rhs.index_;
+        }
+
+    private:
+        const ConcurrentVector* items_ = nullptr;
+        size_t index_ = 0;
+    };
+
+    ConcurrentVector() noexcept = default;
+
+    // Создаёт пустой вектор, блоки которого будут выделяться распределителем alloc
+    explicit ConcurrentVector(const Allocator& alloc) noexcept
+        : Storage(alloc) {
+    }
+
+    // Создаёт пустой вектор с заранее выделенными блоками на capacity элементов
+    explicit ConcurrentVector(ReserveProxyObj reserved, const Allocator& alloc = Allocator())
+        : Storage(alloc) {
+        Reserve(reserved.capacity);  // может бросить исключение
+    }
+
+    // Вектор разделяется между потоками по ссылке, копирование и перемещение запрещены
+    ConcurrentVector(const ConcurrentVector&) = delete;
+    ConcurrentVector& operator=(const ConcurrentVector&) = delete;
+
+    // Разрушает созданные элементы и освобождает блоки.
+    // Вызывается, когда все потоки закончили работу с вектором
+    ~ConcurrentVector() {
+        for (size_t block = 0; block < MAX_BLOCKS; ++block) {
+            Slot* slots = blocks_[block].load(std::memory_order_acquire);
+            if (slots == nullptr) {
+                continue;
+            }
+            const size_t block_size = FIRST_BLOCK_SIZE << block;
+            for (size_t i = 0; i < block_size; ++i) {
+                if (slots[i].ready.load(std::memory_order_acquire)) {
+                    std::destroy_at(slots[i].Get());
+                }
+            }
+            BlockPtr owner(slots, block_size, SlotAllocator(Storage::GetAllocator()));
+        }
+    }
+
+    // Возвращает длину опубликованного префикса: все элементы [0, GetSize()) созданы и видимы вызывающему потоку
+    size_t GetSize() const noexcept {
+        return AdvancePublished();
+    }
+
+    // Сообщает, пуст ли опубликованный префикс
+    bool IsEmpty() const noexcept {
+        return GetSize() == 0;
+    }
+
+    // Возвращает количество элементов, под которые выделены блоки
+    size_t GetCapacity() const noexcept {
+        size_t block_count = 0;
+        while (block_count < MAX_BLOCKS && blocks_[block_count].load(std::memory_order_acquire) != nullptr) {
+            ++block_count;
+        }
+        return CapacityOf(block_count);
+    }
+
+    // Возвращает ссылку на элемент с индексом index.
+    // Индекс должен принадлежать префиксу, ранее полученному через GetSize() в этом потоке
+    Type& operator[](size_t index) noexcept {
+        return *Locate(index).Get();
+    }
+
+    const Type& operator[](size_t index) const noexcept {
+        return *Locate(index).Get();
+    }
+
+    // Выбрасывает исключение std::out_of_range, если элемент index ещё не опубликован
+    const Type& At(size_t index) const {
+        if (index >= GetSize()) {
+            throw out_of_range("Item index is out of range"s);
+        }
+        return (*this)[index];
+    }
+
+    // Заранее выделяет блоки, чтобы вместимость стала не меньше new_capacity.
+    // Может вызываться одновременно с добавлением элементов
+    void Reserve(size_t new_capacity) {
+        for (size_t block = 0; CapacityOf(block) < new_capacity; ++block) {
+            AcquireBlock(block);  // может бросить исключение
+        }
+    }
+
+    // Добавляет элемент в конец вектора и возвращает его индекс.
+    // Безопасно вызывается одновременно из нескольких потоков.
+    // Индекс резервируется одним fetch_add без повторных попыток, блок ячейки выделяется после резервирования.
+    // Если блок выделить не удалось, индекс остаётся брошенным: он запоминается в таблице брошенных индексов
+    // и отдаётся следующему добавлению, так что публикация не останавливается на пустой ячейке навсегда.
+    // Пока таблица заполнена, производитель не бросает исключение, а повторяет выделение сам
+    size_t PushBack(Type item) {
+        size_t index = 0;
+        if (orphan_count_.load(std::memory_order_relaxed) == 0 || !TakeOrphan(index)) {
+            index = reserved_.fetch_add(1, std::memory_order_relaxed);
+        }
+        while (true) {
+            try {
+                Slot& slot = AcquireSlot(index);  // может бросить исключение
+                new (slot.Get()) Type(std::move(item));
+                slot.ready.store(true, std::memory_order_release);
+                return index;
+            }
+            catch (...) {
+                if (AddOrphan(index)) {
+                    throw;
+                }
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    // Создаёт элемент из аргументов args и добавляет его в конец вектора.
+    // Возвращает индекс элемента, адрес которого не меняется до разрушения вектора
+    template <typename... Args>
+    size_t EmplaceBack(Args&&... args) {
+        return PushBack(Type(std::forward<Args>(args)...));  // может бросить исключение
+    }
+
+    // Итераторы обходят префикс, опубликованный к моменту вызова end()
+    ConstIterator begin() const noexcept {
+        return ConstIterator(this, 0);
+    }
+
+    ConstIterator end() const noexcept {
+        return ConstIterator(this, GetSize());
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return begin();
+    }
+
+    ConstIterator cend() const noexcept {
+        return end();
+    }
+
+private:
+    static constexpr size_t CapacityOf(size_t block_count) noexcept {
+        return FIRST_BLOCK_SIZE * ((size_t(1) << block_count) - 1);
+    }
+
+    // Находит ячейку index в уже выделенном блоке
+    Slot& Locate(size_t index) const noexcept {
+        const size_t shifted = index + FIRST_BLOCK_SIZE;
+        const size_t high_bit = HighestBitIndex(shifted);
+        Slot* slots = blocks_[high_bit - FIRST_BLOCK_BITS].load(std::memory_order_acquire);
+        assert(slots != nullptr);
+        return slots[shifted ^ (size_t(1) << high_bit)];
+    }
+
+    // Находит ячейку index, при необходимости выделяя её блок
+    Slot& AcquireSlot(size_t index) {
+        const size_t shifted = index + FIRST_BLOCK_SIZE;
+        const size_t high_bit = HighestBitIndex(shifted);
+        return AcquireBlock(high_bit - FIRST_BLOCK_BITS)[shifted ^ (size_t(1) << high_bit)];
+    }
+
+    // Возвращает блок с номером block, выделяя его при первом обращении.
+    // Если несколько потоков выделили блок одновременно, сохраняется первый, остальные освобождаются
+    Slot* AcquireBlock(size_t block) {
+        if (block >= MAX_BLOCKS) {
+            throw length_error("ConcurrentVector is too large"s);
+        }
+        Slot* slots = blocks_[block].load(std::memory_order_acquire);
+        if (slots != nullptr) {
+            return slots;
+        }
+        BlockPtr new_block(FIRST_BLOCK_SIZE << block, SlotAllocator(Storage::GetAllocator()));  // может бросить исключение
+        if (blocks_[block].compare_exchange_strong(slots, new_block.Get(), std::memory_order_acq_rel)) {
+            return new_block.Release();
+        }
+        return slots;
+    }
+
+    // Запоминает зарезервированный индекс, ячейку которого не удалось выделить.
+    // Возвращает false, если таблица брошенных индексов заполнена
+    bool AddOrphan(size_t index) noexcept {
+        for (std::atomic<size_t>& orphan : orphans_) {
+            size_t empty = 0;
+            if (orphan.compare_exchange_strong(empty, index + 1, std::memory_order_relaxed)) {
+                orphan_count_.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Забирает брошенный индекс из таблицы; добавление заполнит его ячейку вместо резервирования нового
+    bool TakeOrphan(size_t& index) noexcept {
+        for (std::atomic<size_t>& orphan : orphans_) {
+            size_t stored = orphan.load(std::memory_order_relaxed);
+            if (stored != 0 && orphan.compare_exchange_strong(stored, 0, std::memory_order_relaxed)) {
+                orphan_count_.fetch_sub(1, std::memory_order_relaxed);
+                index = stored - 1;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Продвигает границу опубликованного префикса через все подряд готовые элементы.
+    // Готовность ячеек проверяется локально acquire-загрузками, затем весь найденный префикс публикуется
+    // одним compare_exchange, который только увеличивает границу. Поток, прочитавший границу, синхронизируется
+    // с потоком, опубликовавшим её, а через него - с производителями всех элементов префикса
+    size_t AdvancePublished() const noexcept {
+        size_t published = published_.load(std::memory_order_acquire);
+        const size_t reserved = reserved_.load(std::memory_order_relaxed);
+        size_t ready = published;
+        while (ready < reserved) {
+            const size_t shifted = ready + FIRST_BLOCK_SIZE;
+            const size_t high_bit = HighestBitIndex(shifted);
+            const Slot* slots = blocks_[high_bit - FIRST_BLOCK_BITS].load(std::memory_order_acquire);
+            if (slots == nullptr || !slots[shifted ^ (size_t(1) << high_bit)].ready.load(std::memory_order_acquire)) {
+                break;
+            }
+            ++ready;
+        }
+        // При неудаче published получает актуальную границу; если другой поток продвинул её дальше, она и возвращается
+        while (published < ready) {
+            if (published_.compare_exchange_weak(published, ready, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                return ready;
+            }
+        }
+        return published;
+    }
+
+    std::array<std::atomic<Slot*>, MAX_BLOCKS> blocks_ = {};
+    std::atomic<size_t> reserved_ = 0;
+    mutable std::atomic<size_t> published_ = 0;
+    // Брошенные индексы хранятся увеличенными на единицу, ноль обозначает свободную запись.
+    // Счётчик лишь подсказывает добавлению, стоит ли просматривать таблицу
+    std::array<std::atomic<size_t>, MAX_ORPHANS> orphans_ = {};
+    std::atomic<size_t> orphan_count_ = 0;
+};
+
+// Возвращает индекс первого элемента отсортированного массива keys[0, size), не меньшего key.
+// Цикл не зависит от результатов сравнений: на каждом шаге диапазон поиска уменьшается вдвое,
+// а выбор половины для арифметических ключей компилируется в условную пересылку (cmov) без ветвления
+template <typename Key, typename Compare>
+size_t BranchlessLowerBound(const Key* keys, size_t size, const Key& key, const Compare& comp) {
+    if (size == 0) {
+        return 0;
+    }
+    const Key* base = keys;
+    while (size > 1) {
+        const size_t half = size / 2;
+        base = comp(base[half], key) ? base + half : base;
+        size -= half;
+    }
+    return static_cast<size_t>(base - keys) + (comp(*base, key) ? 1 : 0);
+}
+
+// Составляет план слияния отсортированного массива keys[0, size) с отсортированным буфером added[0, added_size),
+// ключ элемента буфера возвращает get_key. Элемент плана i < size обозначает keys[i], а size + j - added[j].
+// Элементы буфера, равные уже попавшим в план, пропускаются. План строится только сравнениями,
+// поэтому исключение компаратора не затрагивает ни массив, ни буфер
+template <typename Key, typename Added, typename GetKey, typename Compare>
+SimpleVector<size_t> MakeMergePlan(const Key* keys, size_t size, const Added* added, size_t added_size,
+    GetKey get_key, const Compare& comp) {
+    SimpleVector<size_t> plan(Reserve(size + added_size));  // может бросить исключение
+    const Key* last = nullptr;
+    auto append_added = [&](size_t j) {
+        const Key& key = get_key(added[j]);
+        if (last == nullptr || comp(*last, key)) {  // может бросить исключение
+            plan.PushBack(size + j);
+            last = &key;
+        }
+    };
+    size_t j = 0;
+    for (size_t i = 0; i < size; ++i) {
+        for (; j < added_size && comp(get_key(added[j]), keys[i]); ++j) {  // может бросить исключение
+            append_added(j);  // может бросить исключение
+        }
+        plan.PushBack(i);
+        last = &keys[i];
+    }
+    for (; j < added_size; ++j) {
+        append_added(j);  // может бросить исключение
+    }
+    return plan;
+}
+
+// Хранилище функционального объекта: компаратора, хеш-функции, предиката равенства.
+// Как и в AllocatorStorage, пустой объект становится базовым классом и не занимает памяти на любом компиляторе,
+// в том числе на MSVC. Tag различает хранилища одного типа, унаследованные одним классом
+template <typename Functor, typename Tag = void, bool IsEmpty = std::is_empty_v<Functor> && !std::is_final_v<Functor>>
+class FunctorStorage {
+public:
+    FunctorStorage() = default;
+
+    explicit FunctorStorage(const Functor& functor)
+        : functor_(functor) {
+    }
+
+    Functor& GetFunctor() noexcept {
+        return functor_;
+    }
+
+    const Functor& GetFunctor() const noexcept {
+        return functor_;
+    }
+
+private:
+    Functor functor_;
+};
+
+template <typename Functor, typename Tag>
+class FunctorStorage<Functor, Tag, true> : private Functor {
+public:
+    FunctorStorage() = default;
+
+    explicit FunctorStorage(const Functor& functor)
+        : Functor(functor) {
+    }
+
+    Functor& GetFunctor() noexcept {
+        return *this;
+    }
+
+    const Functor& GetFunctor() const noexcept {
+        return *this;
+    }
+};
+
+// Упорядоченный ассоциативный массив в двух отсортированных SimpleVector: ключи и значения хранятся раздельно,
+// поэтому поиск проходит по плотному массиву ключей и не обращается к значениям.
+// Подходит для небольших таблиц, которые редко меняются и часто читаются:
+// вставка и удаление одного элемента стоят O(N), поиск - O(log N) без обращений к куче.
+// Как и в std::map, при повторной вставке ключа сохраняется прежнее значение
+template <typename Key, typename Value, typename Compare = std::less<Key>>
+class FlatMap : private FunctorStorage<Compare> {
+    using CompareStorage = FunctorStorage<Compare>;
+
+    // Прежние элементы можно перемещать при слиянии, если перенос ни одного элемента не бросает исключений.
+    // Типы без конструктора копирования перемещаются всегда, и для них слияние даёт только базовую гарантию
+    static constexpr bool MOVE_ON_MERGE = (std::is_nothrow_move_constructible_v<Key> && std::is_nothrow_move_constructible_v<Value>)
+        || !(std::is_copy_constructible_v<Key> && std::is_copy_constructible_v<Value>);
+    // Ключи и значения можно сдвигать на месте при вставке и удалении, если присваивание перемещением не бросает исключений:
+    // иначе сбой посередине сдвига рассинхронизировал бы массивы ключей и значений
+    static constexpr bool SHIFT_IN_PLACE = std::is_nothrow_move_assignable_v<Key> && std::is_nothrow_move_assignable_v<Value>;
+
+    template <bool IsConst>
+    class BasicIterator {
+        using ValuePtr = std::conditional_t<IsConst, const Value*, Value*>;
+
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = std::pair<Key, Value>;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::pair<const Key&, std::conditional_t<IsConst, const Value&, Value&>>;
+        using pointer = void;
+
+        BasicIterator() noexcept = default;
+
+        BasicIterator(const Key* key, ValuePtr value) noexcept
+            : key_(key)
+            , value_(value) {
+        }
+
+        // Неконстантный итератор неявно преобразуется в константный
+        template <bool OtherIsConst, typename = std::enable_if_t<IsConst && !OtherIsConst>>
+        BasicIterator(const BasicIterator<OtherIsConst>& other) noexcept
+            : key_(other.key_)
+            , value_(other.value_) {
+        }
+
+        reference operator*() const noexcept {
+            return { *key_, *value_ };
+        }
+
+        const Key& GetKey() const noexcept {
+            return *key_;
+        }
+
+        auto& GetValue() const noexcept {
+            return *value_;
+        }
+
+        BasicIterator& operator++() noexcept {
+            ++key_;
+            ++value_;
+            return *this;
+        }
+
+        BasicIterator operator++(int) noexcept {
+            BasicIterator old(*this);
+            ++*this;
+            return old;
+        }
+
+        BasicIterator& operator--() noexcept {
+            --key_;
+            --value_;
+            return *this;
+        }
+
+        BasicIterator operator--(int) noexcept {
+            BasicIterator old(*this);
+            --*this;
+            return old;
+        }
+
+        friend bool operator==(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.key_ == rhs.key_;
+        }
+
+        friend bool operator!=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.key_ != rhs.key_;
+        }
+
+    private:
+        friend class BasicIterator<!IsConst>;
+
+        const Key* key_ = nullptr;
+        ValuePtr value_ = nullptr;
+    };
+
+public:
+    using Iterator = BasicIterator<false>;
+    using ConstIterator = BasicIterator<true>;
+
+    FlatMap() = default;
+
+    explicit FlatMap(const Compare& comp)
+        : CompareStorage(comp) {
+    }
+
+    // Создаёт массив из неупорядоченных пар: пары собираются в буфер и сортируются один раз
+    template <typename InputIt>
+    FlatMap(InputIt first, InputIt last, const Compare& comp = Compare())
+        : CompareStorage(comp) {
+        InsertRange(first, last);  // может бросить исключение
+    }
+
+    FlatMap(std::initializer_list<std::pair<Key, Value>> init, const Compare& comp = Compare())
+        : FlatMap(init.begin(), init.end(), comp) {
+    }
+
+    size_t GetSize() const noexcept {
+        return keys_.GetSize();
+    }
+
+    bool IsEmpty() const noexcept {
+        return keys_.IsEmpty();
+    }
+
+    void Clear() noexcept {
+        keys_.Clear();
+        values_.Clear();
+    }
+
+    void Reserve(size_t capacity) {
+        keys_.Reserve(capacity);  // может бросить исключение
+        values_.Reserve(capacity);  // может бросить исключение
+    }
+
+    // Ключи в порядке возрастания
+    Span<const Key> Keys() const noexcept {
+        return { keys_.Data(), keys_.GetSize() };
+    }
+
+    // Значения в порядке возрастания соответствующих им ключей
+    Span<Value> Values() noexcept {
+        return { values_.Data(), values_.GetSize() };
+    }
+
+    Span<const Value> Values() const noexcept {
+        return { values_.Data(), values_.GetSize() };
+    }
+
+    // Возвращает итератор на элемент с ключом key либо end(), если ключа нет
+    Iterator Find(const Key& key) {
+        const size_t index = FindIndex(key);
+        return index == GetSize() ? end() : MakeIterator(index);
+    }
+
+    ConstIterator Find(const Key& key) const {
+        const size_t index = FindIndex(key);
+        return index == GetSize() ? end() : MakeIterator(index);
+    }
+
+    bool Contains(const Key& key) const {
+        return FindIndex(key) != GetSize();
+    }
+
+    // Возвращает значение по ключу key
+    // Выбрасывает исключение std::out_of_range, если ключа нет
+    Value& At(const Key& key) {
+        const size_t index = FindIndex(key);
+        if (index == GetSize()) {
+            throw out_of_range("Key is not found in FlatMap"s);
+        }
+        return values_[index];
+    }
+
+    const Value& At(const Key& key) const {
+        const size_t index = FindIndex(key);
+        if (index == GetSize()) {
+            throw out_of_range("Key is not found in FlatMap"s);
+        }
+        return values_[index];
+    }
+
+    // Возвращает значение по ключу key, вставляя значение по умолчанию, если ключа нет
+    Value& operator[](const Key& key) {
+        const size_t index = FindIndex(key);
+        if (index != GetSize()) {
+            return values_[index];
+        }
+        return Insert(key, Value()).first.GetValue();  // может бросить исключение
+    }
+
+    // Вставляет пару, если ключа key ещё нет. Возвращает итератор на элемент с ключом key
+    // и признак того, что вставка произошла.
+    // Если сдвиг элементов может бросить исключение, элементы переносятся в новые массивы
+    // так же, как в InsertRange, и при исключении массив не меняется
+    std::pair<Iterator, bool> Insert(Key key, Value value) {
+        const size_t index = BranchlessLowerBound(keys_.Data(), keys_.GetSize(), key, GetCompare());
+        if (index != GetSize() && !GetCompare()(key, keys_[index])) {
+            return { MakeIterator(index), false };
+        }
+        if constexpr (SHIFT_IN_PLACE) {
+            keys_.Insert(keys_.begin() + index, std::move(key));  // может бросить исключение
+            try {
+                values_.Insert(values_.begin() + index, std::move(value));  // может бросить исключение
+            }
+            catch (...) {
+                keys_.Erase(keys_.begin() + index);
+                throw;
+            }
+        }
+        else {
+            SimpleVector<Key> keys(::Reserve(GetSize() + 1));  // может бросить исключение
+            SimpleVector<Value> values(::Reserve(GetSize() + 1));  // может бросить исключение
+            for (size_t i = 0; i < index; ++i) {
+                TransferItem(i, keys, values);  // может бросить исключение
+            }
+            keys.EmplaceBack(std::move(key));  // может бросить исключение
+            values.EmplaceBack(std::move(value));  // может бросить исключение
+            for (size_t i = index; i < GetSize(); ++i) {
+                TransferItem(i, keys, values);  // может бросить исключение
+            }
+            keys_.swap(keys);
+            values_.swap(values);
+        }
+        return { MakeIterator(index), true };
+    }
+
+    // Вставляет пары [first, last) за O(N + M log M): новые пары сортируются в отдельном буфере
+    // и сливаются с массивом за один проход, вместо M вставок со сдвигом "хвоста".
+    // Пары с уже существующими ключами пропускаются. При исключении массив не меняется:
+    // сначала все сравнения составляют план слияния, затем элементы переносятся в новые массивы.
+    // Прежние элементы перемещаются, только если перенос любого элемента не бросает исключений, иначе копируются
+    template <typename InputIt>
+    void InsertRange(InputIt first, InputIt last) {
+        SimpleVector<std::pair<Key, Value>> added;
+        added.AppendRange(first, last);  // может бросить исключение
+        if (added.IsEmpty()) {
+            return;
+        }
+        // Устойчивая сортировка оставляет первой из равных пар ту, что встретилась в диапазоне раньше
+        std::stable_sort(added.begin(), added.end(), [this](const auto& lhs, const auto& rhs) {
+            return GetCompare()(lhs.first, rhs.first);
+        });  // может бросить исключение
+
+        const SimpleVector<size_t> plan = MakeMergePlan(keys_.Data(), GetSize(), added.Data(), added.GetSize(),
+            [](const std::pair<Key, Value>& item) -> const Key& { return item.first; }, GetCompare());  // может бросить исключение
+
+        // Векторы заранее вмещают результат, поэтому EmplaceBack ниже не перевыделяет память
+        SimpleVector<Key> keys(::Reserve(plan.GetSize()));  // может бросить исключение
+        SimpleVector<Value> values(::Reserve(plan.GetSize()));  // может бросить исключение
+        for (const size_t source : plan) {
+            if (source < GetSize()) {
+                TransferItem(source, keys, values);  // может бросить исключение
+            }
+            else {
+                std::pair<Key, Value>& item = added[source - GetSize()];
+                keys.EmplaceBack(std::move(item.first));  // может бросить исключение
+                values.EmplaceBack(std::move(item.second));  // может бросить исключение
+            }
+        }
+        keys_.swap(keys);
+        values_.swap(values);
+    }
+
+    // Удаляет элемент с ключом key. Возвращает true, если ключ был в массиве.
+    // Если сдвиг элементов может бросить исключение, оставшиеся элементы переносятся в новые массивы
+    // так же, как в InsertRange, и при исключении массив не меняется
+    bool Erase(const Key& key) {
+        const size_t index = FindIndex(key);
+        if (index == GetSize()) {
+            return false;
+        }
+        if constexpr (SHIFT_IN_PLACE) {
+            values_.Erase(values_.begin() + index);
+            keys_.Erase(keys_.begin() + index);
+        }
+        else {
+            SimpleVector<Key> keys(::Reserve(GetSize() - 1));  // может бросить исключение
+            SimpleVector<Value> values(::Reserve(GetSize() - 1));  // может бросить исключение
+            for (size_t i = 0; i < GetSize(); ++i) {
+                if (i != index) {
+                    TransferItem(i, keys, values);  // может бросить исключение
+                }
+            }
+            keys_.swap(keys);
+            values_.swap(values);
+        }
+        return true;
+    }
+
+    void swap(FlatMap& other) noexcept {
+        keys_.swap(other.keys_);
+        values_.swap(other.values_);
+        std::swap(GetCompare(), other.GetCompare());
+    }
+
+    Iterator begin() noexcept {
+        return MakeIterator(0);
+    }
+
+    Iterator end() noexcept {
+        return MakeIterator(GetSize());
+    }
+
+    ConstIterator begin() const noexcept {
+        return MakeIterator(0);
+    }
+
+    ConstIterator end() const noexcept {
+        return MakeIterator(GetSize());
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return begin();
+    }
+
+    ConstIterator cend() const noexcept {
+        return end();
+    }
+
+private:
+    Compare& GetCompare() noexcept {
+        return CompareStorage::GetFunctor();
+    }
+
+    const Compare& GetCompare() const noexcept {
+        return CompareStorage::GetFunctor();
+    }
+
+    // Добавляет прежний элемент index в конец новых массивов keys и values, заранее вмещающих результат.
+    // Элемент перемещается, если перенос любого элемента не бросает исключений, иначе копируется
+    void TransferItem(size_t index, SimpleVector<Key>& keys, SimpleVector<Value>& values) {
+        if constexpr (MOVE_ON_MERGE) {
+            keys.EmplaceBack(std::move(keys_[index]));
+            values.EmplaceBack(std::move(values_[index]));
+        }
+        else {
+            keys.EmplaceBack(keys_[index]);  // может бросить исключение
+            values.EmplaceBack(values_[index]);  // может бросить исключение
+        }
+    }
+
+    // Возвращает индекс ключа key либо GetSize(), если ключа нет
+    size_t FindIndex(const Key& key) const {
+        const size_t index = BranchlessLowerBound(keys_.Data(), keys_.GetSize(), key, GetCompare());
+        return index != GetSize() && !GetCompare()(key, keys_[index]) ? index : GetSize();
+    }
+
+    Iterator MakeIterator(size_t index) noexcept {
+        return { keys_.Data() + index, values_.Data() + index };
+    }
+
+    ConstIterator MakeIterator(size_t index) const noexcept {
+        return { keys_.Data() + index, values_.Data() + index };
+    }
+
+    SimpleVector<Key> keys_;
+    SimpleVector<Value> values_;
+};
+
+template <typename Key, typename Value, typename Compare>
+bool operator==(const FlatMap<Key, Value, Compare>& lhs, const FlatMap<Key, Value, Compare>& rhs) {
+    return lhs.GetSize() == rhs.GetSize()
+        && std::equal(lhs.Keys().begin(), lhs.Keys().end(), rhs.Keys().begin())
+        && std::equal(lhs.Values().begin(), lhs.Values().end(), rhs.Values().begin());  // может бросить исключение
+}
+
+template <typename Key, typename Value, typename Compare>
+bool operator!=(const FlatMap<Key, Value, Compare>& lhs, const FlatMap<Key, Value, Compare>& rhs) {
+    return !(lhs == rhs);  // может бросить исключение
+}
+
+// Упорядоченное множество в отсортированном SimpleVector с тем же поиском, что и у FlatMap.
+// Итераторы константные: изменение элемента нарушило бы порядок
+template <typename Key, typename Compare = std::less<Key>>
+class FlatSet : private FunctorStorage<Compare> {
+    using CompareStorage = FunctorStorage<Compare>;
+
+public:
+    using ConstIterator = const Key*;
+    using Iterator = ConstIterator;
+
+    FlatSet() = default;
+
+    explicit FlatSet(const Compare& comp)
+        : CompareStorage(comp) {
+    }
+
+    // Создаёт множество из неупорядоченного диапазона: элементы собираются в буфер и сортируются один раз
+    template <typename InputIt>
+    FlatSet(InputIt first, InputIt last, const Compare& comp = Compare())
+        : CompareStorage(comp) {
+        InsertRange(first, last);  // может бросить исключение
+    }
+
+    FlatSet(std::initializer_list<Key> init, const Compare& comp = Compare())
+        : FlatSet(init.begin(), init.end(), comp) {
+    }
+
+    size_t GetSize() const noexcept {
+        return keys_.GetSize();
+    }
+
+    bool IsEmpty() const noexcept {
+        return keys_.IsEmpty();
+    }
+
+    void Clear() noexcept {
+        keys_.Clear();
+    }
+
+    void Reserve(size_t capacity) {
+        keys_.Reserve(capacity);  // может бросить исключение
+    }
+
+    // Возвращает итератор на элемент, равный key, либо end()
+    ConstIterator Find(const Key& key) const {
+        const size_t index = BranchlessLowerBound(keys_.Data(), keys_.GetSize(), key, GetCompare());
+        return index != GetSize() && !GetCompare()(key, keys_[index]) ? begin() + index : end();
+    }
+
+    bool Contains(const Key& key) const {
+        return Find(key) != end();
+    }
+
+    // Вставляет key, если равного ему элемента ещё нет. Возвращает итератор на элемент, равный key,
+    // и признак того, что вставка произошла
+    std::pair<ConstIterator, bool> Insert(Key key) {
+        const size_t index = BranchlessLowerBound(keys_.Data(), keys_.GetSize(), key, GetCompare());
+        if (index != GetSize() && !GetCompare()(key, keys_[index])) {
+            return { begin() + index, false };
+        }
+        keys_.Insert(keys_.begin() + index, std::move(key));  // может бросить исключение
+        return { begin() + index, true };
+    }
+
+    // Вставляет элементы [first, last), сортируя их в отдельном буфере и сливая с множеством за один проход.
+    // При исключении множество не меняется: сначала сравнения составляют план слияния, затем элементы
+    // переносятся в новый массив, причём прежние элементы перемещаются, только если перемещение не бросает исключений
+    template <typename InputIt>
+    void InsertRange(InputIt first, InputIt last) {
+        SimpleVector<Key> added;
+        added.AppendRange(first, last);  // может бросить исключение
+        if (added.IsEmpty()) {
+            return;
+        }
+        std::stable_sort(added.begin(), added.end(), GetCompare());  // может бросить исключение
+
+        const SimpleVector<size_t> plan = MakeMergePlan(keys_.Data(), GetSize(), added.Data(), added.GetSize(),
+            [](const Key& key) -> const Key& { return key; }, GetCompare());  // может бросить исключение
+
+        SimpleVector<Key> keys(::Reserve(plan.GetSize()));  // может бросить исключение
+        for (const size_t source : plan) {
+            if (source >= GetSize()) {
+                keys.EmplaceBack(std::move(added[source - GetSize()]));  // может бросить исключение
+            }
+            else if constexpr (std::is_nothrow_move_constructible_v<Key> || !std::is_copy_constructible_v<Key>) {
+                keys.EmplaceBack(std::move(keys_[source]));
+            }
+            else {
+                keys.EmplaceBack(keys_[source]);  // может бросить исключение
+            }
+        }
+        keys_.swap(keys);
+    }
+
+    // Удаляет элемент, равный key. Возвращает true, если он был в множестве
+    bool Erase(const Key& key) {
+        const ConstIterator pos = Find(key);
+        if (pos == end()) {
+            return false;
+        }
+        keys_.Erase(keys_.begin() + (pos - begin()));  // может бросить исключение
+        return true;
+    }
+
+    void swap(FlatSet& other) noexcept {
+        keys_.swap(other.keys_);
+        std::swap(GetCompare(), other.GetCompare());
+    }
+
+    ConstIterator begin() const noexcept {
+        return keys_.Data();
+    }
+
+    ConstIterator end() const noexcept {
+        return keys_.Data() + keys_.GetSize();
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return begin();
+    }
+
+    ConstIterator cend() const noexcept {
+        return end();
+    }
+
+private:
+    Compare& GetCompare() noexcept {
+        return CompareStorage::GetFunctor();
+    }
+
+    const Compare& GetCompare() const noexcept {
+        return CompareStorage::GetFunctor();
+    }
+
+    SimpleVector<Key> keys_;
+};
+
+template <typename Key, typename Compare>
+bool operator==(const FlatSet<Key, Compare>& lhs, const FlatSet<Key, Compare>& rhs) {
+    return lhs.GetSize() == rhs.GetSize() && std::equal(lhs.begin(), lhs.end(), rhs.begin());  // может бросить исключение
+}
+
+template <typename Key, typename Compare>
+bool operator!=(const FlatSet<Key, Compare>& lhs, const FlatSet<Key, Compare>& rhs) {
+    return !(lhs == rhs);  // может бросить исключение
+}
+
+// Хеш-таблица с открытой адресацией в духе SwissTable. Пары хранятся прямо в массиве ячеек ArrayPtr,
+// а для каждой ячейки заведён управляющий байт: пустая, удалённая или занятая - тогда в байте лежат
+// младшие 7 бит хеша ключа. Ячейки разбиты на группы по GROUP_WIDTH, и поиск сравнивает управляющие байты
+// целой группы с 7 битами хеша одной инструкцией SSE2, обращаясь к ключам только при совпадении байта.
+// Группы перебираются с треугольным шагом от группы, выбранной старшими битами хеша. Поиск заканчивается
+// на группе, где есть пустая ячейка, поэтому при удалении ячейка помечается удалённой,
+// если её группа была заполнена целиком. Заполнение не превышает 7/8 вместимости.
+// Любая вставка с перехешированием делает итераторы и ссылки на элементы недействительными
+// Теги, различающие хранилища хеш-функции и предиката равенства FlatHashMap, если их типы совпадают
+struct HashStorageTag;
+struct KeyEqualStorageTag;
+
+template <typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class FlatHashMap : private FunctorStorage<Hash, HashStorageTag>, private FunctorStorage<KeyEqual, KeyEqualStorageTag> {
+    using HashStorage = FunctorStorage<Hash, HashStorageTag>;
+    using KeyEqualStorage = FunctorStorage<KeyEqual, KeyEqualStorageTag>;
+    using Entry = std::pair<Key, Value>;
+    using Control = int8_t;
+
+    static constexpr size_t GROUP_WIDTH = 16;
+    static constexpr Control EMPTY = -128;
+    static constexpr Control DELETED = -2;
+    // Результат шага перебора групп, означающий "перейти к следующей группе"
+    static constexpr size_t CONTINUE_PROBE = std::numeric_limits<size_t>::max();
+
+    // Битовая маска ячеек группы: бит i соответствует i-й ячейке
+    class GroupMask {
+    public:
+        explicit GroupMask(uint32_t bits) noexcept
+            : bits_(bits) {
+        }
+
+        bool IsEmpty() const noexcept {
+            return bits_ == 0;
+        }
+
+        // Возвращает индекс младшей отмеченной ячейки и снимает с неё отметку
+        size_t PopLowest() noexcept {
+            const size_t index = LowestBitIndex(bits_);
+            bits_ &= bits_ - 1;
+            return index;
+        }
+
+    private:
+        uint32_t bits_;
+    };
+
+    // Управляющие байты одной группы
+    class Group {
+    public:
+        explicit Group(const Control* ctrl) noexcept
+#ifdef SIMPLE_VECTOR_X86_SIMD
+            : ctrl_(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl))) {
+        }
+#else
+            : ctrl_(ctrl) {
+        }
+#endif
+
+        // Ячейки, управляющий байт которых равен h2
+        GroupMask Match(Control h2) const noexcept {
+#ifdef SIMPLE_VECTOR_X86_SIMD
+            return GroupMask(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl_, _mm_set1_epi8(h2)))));
+#else
+            uint32_t bits = 0;
+            for (size_t i = 0; i < GROUP_WIDTH; ++i) {
+                bits |= static_cast<uint32_t>(ctrl_[i] == h2) << i;
+            }
+            return GroupMask(bits);
+#endif
+        }
+
+        GroupMask MatchEmpty() const noexcept {
+            return Match(EMPTY);
+        }
+
+        // Пустые и удалённые ячейки - единственные управляющие байты со знаковым битом
+        GroupMask MatchEmptyOrDeleted() const noexcept {
+#ifdef SIMPLE_VECTOR_X86_SIMD
+            return GroupMask(static_cast<uint32_t>(_mm_movemask_epi8(ctrl_)));
+#else
+            uint32_t bits = 0;
+            for (size_t i = 0; i < GROUP_WIDTH; ++i) {
+                bits |= static_cast<uint32_t>(ctrl_[i] < 0) << i;
+            }
+            return GroupMask(bits);
+#endif
+        }
+
+    private:
+#ifdef SIMPLE_VECTOR_X86_SIMD
+        __m128i ctrl_;
+#else
+        const Control* ctrl_;
+#endif
+    };
+
+    template <bool IsConst>
+    class BasicIterator {
+        using EntryPtr = std::conditional_t<IsConst, const Entry*, Entry*>;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::pair<Key, Value>;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::pair<const Key&, std::conditional_t<IsConst, const Value&, Value&>>;
+        using pointer = void;
+
+        BasicIterator() noexcept = default;
+
+        // Неконстантный итератор неявно преобразуется в константный
+        template <bool OtherIsConst, typename = std::enable_if_t<IsConst && !OtherIsConst>>
+        BasicIterator(const BasicIterator<OtherIsConst>& other) noexcept
+            : ctrl_(other.ctrl_)
+            , ctrl_end_(other.ctrl_end_)
+            , entry_(other.entry_) {
+        }
+
+        reference operator*() const noexcept {
+            return { entry_->first, entry_->second };
+        }
+
+        const Key& GetKey() const noexcept {
+            return entry_->first;
+        }
+
+        auto& GetValue() const noexcept {
+            return entry_->second;
+        }
+
+        BasicIterator& operator++() noexcept {
+            ++ctrl_;
+            ++entry_;
+            SkipFree();
+            return *this;
+        }
+
+        BasicIterator operator++(int) noexcept {
+            BasicIterator old(*this);
+            ++*this;
+            return old;
+        }
+
+        friend bool operator==(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.ctrl_ == rhs.ctrl_;
+        }
+
+        friend bool operator!=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.ctrl_ != rhs.ctrl_;
+        }
+
+    private:
+        friend class FlatHashMap;
+        friend class BasicIterator<!IsConst>;
+
+        BasicIterator(const Control* ctrl, const Control* ctrl_end, EntryPtr entry) noexcept
+            : ctrl_(ctrl)
+            , ctrl_end_(ctrl_end)
+            , entry_(entry) {
+        }
+
+        // Переходит к ближайшей занятой ячейке либо к концу таблицы
+        void SkipFree() noexcept {
+            while (ctrl_ != ctrl_end_ && *ctrl_ < 0) {
+                ++ctrl_;
+                ++entry_;
+            }
+        }
+
+        const Control* ctrl_ = nullptr;
+        const Control* ctrl_end_ = nullptr;
+        EntryPtr entry_ = nullptr;
+    };
+
+public:
+    using Iterator = BasicIterator<false>;
+    using ConstIterator = BasicIterator<true>;
+
+    FlatHashMap() = default;
+
+    explicit FlatHashMap(size_t capacity) {
+        Reserve(capacity);  // может бросить исключение
+    }
+
+    FlatHashMap(std::initializer_list<std::pair<Key, Value>> init) {
+        Reserve(init.size());  // может бросить исключение
+        for (const auto& [key, value] : init) {
+            Insert(key, value);  // может бросить исключение
+        }
+    }
+
+    FlatHashMap(const FlatHashMap& other)
+        : HashStorage(other.GetHash())
+        , KeyEqualStorage(other.GetKeyEqual()) {
+        Reserve(other.size_);  // может бросить исключение
+        for (const auto& [key, value] : other) {
+            InsertUnique(Entry(key, value), HashOf(key));  // может бросить исключение
+        }
+    }
+
+    FlatHashMap(FlatHashMap&& other) noexcept {
+        swap(other);
+    }
+
+    FlatHashMap& operator=(const FlatHashMap& rhs) {
+        if (&rhs != this) {
+            FlatHashMap rhs_copy(rhs);  // может бросить исключение
+            swap(rhs_copy);
+        }
+        return *this;
+    }
+
+    FlatHashMap& operator=(FlatHashMap&& rhs) noexcept {
+        if (&rhs != this) {
+            Clear();
+            swap(rhs);
+        }
+        return *this;
+    }
+
+    ~FlatHashMap() {
+        DestroyEntries();
+    }
+
+    size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    // Возвращает количество ячеек таблицы
+    size_t GetCapacity() const noexcept {
+        return entries_.GetSize();
+    }
+
+    // Удаляет все элементы, сохраняя массив ячеек
+    void Clear() noexcept {
+        DestroyEntries();
+        std::fill(ctrl_.Get(), ctrl_.Get() + GetCapacity(), EMPTY);
+        size_ = 0;
+        growth_left_ = MaxLoad(GetCapacity());
+    }
+
+    // Готовит таблицу к хранению count элементов без перехеширования
+    void Reserve(size_t count) {
+        if (count > size_ + growth_left_) {
+            Rehash(CapacityFor(count));  // может бросить исключение
+        }
+    }
+
+    // Возвращает итератор на элемент с ключом key либо end(), если ключа нет
+    Iterator Find(const Key& key) {
+        const size_t index = FindIndex(key, HashOf(key));
+        return index == GetCapacity() ? end() : MakeIterator(index);
+    }
+
+    ConstIterator Find(const Key& key) const {
+        const size_t index = FindIndex(key, HashOf(key));
+        return index == GetCapacity() ? end() : MakeIterator(index);
+    }
+
+    bool Contains(const Key& key) const {
+        return FindIndex(key, HashOf(key)) != GetCapacity();
+    }
+
+    // Возвращает значение по ключу key
+    // Выбрасывает исключение std::out_of_range, если ключа нет
+    Value& At(const Key& key) {
+        const size_t index = FindIndex(key, HashOf(key));
+        if (index == GetCapacity()) {
+            throw out_of_range("Key is not found in FlatHashMap"s);
+        }
+        return entries_[index].second;
+    }
+
+    const Value& At(const Key& key) const {
+        const size_t index = FindIndex(key, HashOf(key));
+        if (index == GetCapacity()) {
+            throw out_of_range("Key is not found in FlatHashMap"s);
+        }
+        return entries_[index].second;
+    }
+
+    // Возвращает значение по ключу key, вставляя значение по умолчанию, если ключа нет
+    Value& operator[](const Key& key) {
+        const size_t hash = HashOf(key);
+        const size_t index = FindIndex(key, hash);
+        if (index != GetCapacity()) {
+            return entries_[index].second;
+        }
+        return entries_[InsertUnique(Entry(key, Value()), hash)].second;  // может бросить исключение
+    }
+
+    // Вставляет пару, если ключа key ещё нет. Возвращает итератор на элемент с ключом key
+    // и признак того, что вставка произошла
+    std::pair<Iterator, bool> Insert(Key key, Value value) {
+        const size_t hash = HashOf(key);
+        const size_t index = FindIndex(key, hash);
+        if (index != GetCapacity()) {
+            return { MakeIterator(index), false };
+        }
+        return { MakeIterator(InsertUnique(Entry(std::move(key), std::move(value)), hash)), true };  // может бросить исключение
+    }
+
+    // Удаляет элемент с ключом key. Возвращает true, если ключ был в таблице
+    bool Erase(const Key& key) {
+        const size_t index = FindIndex(key, HashOf(key));
+        if (index == GetCapacity()) {
+            return false;
+        }
+        std::destroy_at(&entries_[index]);
+        --size_;
+        // Если в группе осталась пустая ячейка, ни одна цепочка поиска не проходит через группу дальше
+        if (!Group(&ctrl_[GroupStart(index)]).MatchEmpty().IsEmpty()) {
+            ctrl_[index] = EMPTY;
+            ++growth_left_;
+        }
+        else {
+            ctrl_[index] = DELETED;
+        }
+        return true;
+    }
+
+    void swap(FlatHashMap& other) noexcept {
+        ctrl_.swap(other.ctrl_);
+        entries_.swap(other.entries_);
+        std::swap(size_, other.size_);
+        std::swap(growth_left_, other.growth_left_);
+        std::swap(GetHash(), other.GetHash());
+        std::swap(GetKeyEqual(), other.GetKeyEqual());
+    }
+
+    Iterator begin() noexcept {
+        Iterator it = MakeIterator(0);
+        it.SkipFree();
+        return it;
+    }
+
+    Iterator end() noexcept {
+        return MakeIterator(GetCapacity());
+    }
+
+    ConstIterator begin() const noexcept {
+        ConstIterator it = MakeIterator(0);
+        it.SkipFree();
+        return it;
+    }
+
+    ConstIterator end() const noexcept {
+        return MakeIterator(GetCapacity());
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return begin();
+    }
+
+    ConstIterator cend() const noexcept {
+        return end();
+    }
+
+private:
+    // Максимальное число занятых и удалённых ячеек в таблице вместимостью capacity
+    static size_t MaxLoad(size_t capacity) noexcept {
+        return capacity - capacity / 8;
+    }
+
+    // Наименьшая вместимость - степень двойки, не меньшая GROUP_WIDTH, - вмещающая count элементов
+    static size_t CapacityFor(size_t count) noexcept {
+        size_t capacity = GROUP_WIDTH;
+        while (MaxLoad(capacity) < count) {
+            capacity *= 2;
+        }
+        return capacity;
+    }
+
+    static size_t GroupStart(size_t index) noexcept {
+        return index & ~(GROUP_WIDTH - 1);
+    }
+
+    // std::hash для целых чисел - тождественная функция, поэтому хеш перемешивается умножением:
+    // и старшие биты (номер группы), и младшие 7 бит (управляющий байт) должны зависеть от всего ключа
+    size_t HashOf(const Key& key) const {
+        const uint64_t hash = static_cast<uint64_t>(GetHash()(key)) * 0x9E3779B97F4A7C15ull;
+        return static_cast<size_t>(hash ^ (hash >> 32));
+    }
+
+    static Control H2(size_t hash) noexcept {
+        return static_cast<Control>(hash & 0x7F);
+    }
+
+    // Перебирает начала групп, начиная с группы, выбранной хешем, и возвращает первый результат
+    // visit(group_start), отличный от CONTINUE_PROBE. Треугольный шаг обходит все группы таблицы,
+    // так как их количество - степень двойки, а пустые ячейки в таблице есть всегда
+    template <typename Visit>
+    size_t Probe(size_t hash, Visit visit) const {
+        const size_t group_mask = GetCapacity() / GROUP_WIDTH - 1;
+        size_t group = (hash >> 7) & group_mask;
+        for (size_t step = 1;; ++step) {
+            if (const size_t result = visit(group * GROUP_WIDTH); result != CONTINUE_PROBE) {
+                return result;
+            }
+            group = (group + step) & group_mask;
+        }
+    }
+
+    // Возвращает индекс ячейки с ключом key либо GetCapacity(), если ключа нет
+    size_t FindIndex(const Key& key, size_t hash) const {
+        if (size_ == 0) {
+            return GetCapacity();
+        }
+        const Control h2 = H2(hash);
+        return Probe(hash, [&](size_t start) {
+            const Group group(&ctrl_[start]);
+            for (GroupMask match = group.Match(h2); !match.IsEmpty();) {
+                const size_t index = start + match.PopLowest();
+                if (GetKeyEqual()(entries_[index].first, key)) {
+                    return index;
+                }
+            }
+            // Ключ с таким хешем был бы помещён не дальше первой группы с пустой ячейкой
+            return group.MatchEmpty().IsEmpty() ? CONTINUE_PROBE : GetCapacity();
+        });
+    }
+
+    // Возвращает первую пустую или удалённую ячейку на пути поиска хеша hash
+    size_t FindFreeIndex(size_t hash) const {
+        return Probe(hash, [this](size_t start) {
+            GroupMask free = Group(&ctrl_[start]).MatchEmptyOrDeleted();
+            return free.IsEmpty() ? CONTINUE_PROBE : start + free.PopLowest();
+        });
+    }
+
+    // Помещает пару с ключом, которого нет в таблице, и возвращает индекс её ячейки
+    size_t InsertUnique(Entry&& entry, size_t hash) {
+        size_t index = GetCapacity() > 0 ? FindFreeIndex(hash) : 0;
+        if (GetCapacity() == 0 || (ctrl_[index] == EMPTY && growth_left_ == 0)) {
+            // Занятые ячейки составляют больше половины допустимой нагрузки - таблица растёт,
+            // иначе её заполнили удалённые ячейки, и достаточно перехешировать в той же вместимости
+            Rehash(size_ + 1 > MaxLoad(GetCapacity()) / 2 ? CapacityFor(std::max(size_ + 1, GetCapacity())) : GetCapacity());  // может бросить исключение
+            index = FindFreeIndex(hash);
+        }
+        new (&entries_[index]) Entry(std::move(entry));  // может бросить исключение
+        if (ctrl_[index] == EMPTY) {
+            --growth_left_;
+        }
+        ctrl_[index] = H2(hash);
+        ++size_;
+        return index;
+    }
+
+    // Переносит элементы в новую таблицу вместимостью capacity.
+    // При исключении во время копирования элементов таблица не меняется
+    void Rehash(size_t capacity) {
+        ArrayPtr<Control> new_ctrl(capacity);  // может бросить исключение
+        std::fill(new_ctrl.Get(), new_ctrl.Get() + capacity, EMPTY);
+        ArrayPtr<Entry, true> new_entries(capacity);  // может бросить исключение
+
+        FlatHashMap rehashed;
+        rehashed.ctrl_.swap(new_ctrl);
+        rehashed.entries_.swap(new_entries);
+        rehashed.growth_left_ = MaxLoad(capacity);
+        rehashed.GetHash() = GetHash();
+        rehashed.GetKeyEqual() = GetKeyEqual();
+        for (size_t i = 0; i < GetCapacity(); ++i) {
+            if (ctrl_[i] >= 0) {
+                const size_t hash = HashOf(entries_[i].first);
+                const size_t index = rehashed.FindFreeIndex(hash);
+                new (&rehashed.entries_[index]) Entry(std::move_if_noexcept(entries_[i]));  // может бросить исключение
+                rehashed.ctrl_[index] = H2(hash);
+                --rehashed.growth_left_;
+                ++rehashed.size_;
+            }
+        }
+        swap(rehashed);
+    }
+
+    Hash& GetHash() noexcept {
+        return HashStorage::GetFunctor();
+    }
+
+    const Hash& GetHash() const noexcept {
+        return HashStorage::GetFunctor();
+    }
+
+    KeyEqual& GetKeyEqual() noexcept {
+        return KeyEqualStorage::GetFunctor();
+    }
+
+    const KeyEqual& GetKeyEqual() const noexcept {
+        return KeyEqualStorage::GetFunctor();
+    }
+
+    void DestroyEntries() noexcept {
+        if constexpr (!std::is_trivially_destructible_v<Entry>) {
+            for (size_t i = 0; i < GetCapacity() && size_ > 0; ++i) {
+                if (ctrl_[i] >= 0) {
+                    std::destroy_at(&entries_[i]);
+                }
+            }
+        }
+    }
+
+    Iterator MakeIterator(size_t index) noexcept {
+        return { ctrl_.Get() + index, ctrl_.Get() + GetCapacity(), entries_.Get() + index };
+    }
+
+    ConstIterator MakeIterator(size_t index) const noexcept {
+        return { ctrl_.Get() + index, ctrl_.Get() + GetCapacity(), entries_.Get() + index };
+    }
+
+    ArrayPtr<Control> ctrl_;
+    ArrayPtr<Entry, true> entries_;
+    size_t size_ = 0;
+    // Сколько пустых ячеек ещё можно занять до перехеширования
+    size_t growth_left_ = 0;
+};
+
+class X {
+public:
+    X()
+        : X(5) {
+    }
+    X(size_t num)
+        : x_(num) {
+    }
+    X(const X& other) = delete;
+    X& operator=(const X& other) = delete;
+    X(X&& other) {
+        x_ = exchange(other.x_, 0);
+    }
+    X& operator=(X&& other) {
+        x_ = exchange(other.x_, 0);
+        return *this;
+    }
+    size_t GetX() const {
+        return x_;
+    }
+
+private:
+    size_t x_;
+};
+
+SimpleVector<int> GenerateVector(size_t size) {
+    SimpleVector<int> v(size);
+    iota(v.begin(), v.end(), 1);
+    return v;
+}
+
+void TestTemporaryObjConstructor() {
+    const size_t size = 1000000;
+    cout << "Test with temporary object, copy elision" << endl;
+    SimpleVector<int> moved_vector(GenerateVector(size));
+    assert(moved_vector.GetSize() == size);
+    cout << "Done!" << endl << endl;
+}
+
+void TestTemporaryObjOperator() {
+    const size_t size = 1000000;
+    cout << "Test with temporary object, operator=" << endl;
+    SimpleVector<int> moved_vector;
+    assert(moved_vector.GetSize() == 0);
+    moved_vector = GenerateVector(size);
+    assert(moved_vector.GetSize() == size);
+    cout << "Done!" << endl << endl;
+}
+
+void TestNamedMoveConstructor() {
+    const size_t size = 1000000;
+    cout << "Test with named object, move constructor" << endl;
+    SimpleVector<int> vector_to_move(GenerateVector(size));
+    assert(vector_to_move.GetSize() == size);
+    [[maybe_unused]] const int* items = vector_to_move.Data();
+    [[maybe_unused]] const size_t capacity = vector_to_move.GetCapacity();
+
+    SimpleVector<int> moved_vector(move(vector_to_move));
+    assert(moved_vector.GetSize() == size);
+    assert(vector_to_move.GetSize() == 0);
+    // буфер перехвачен без выделения памяти и копирования элементов
+    assert(moved_vector.Data() == items);
+    assert(moved_vector.GetCapacity() == capacity);
+    assert(vector_to_move.GetCapacity() == 0);
+    cout << "Done!" << endl << endl;
+}
+
+void TestNamedMoveOperator() {
+    const size_t size = 1000000;
+    cout << "Test with named object, operator=" << endl;
+    SimpleVector<int> vector_to_move(GenerateVector(size));
+    assert(vector_to_move.GetSize() == size);
+    [[maybe_unused]] const int* items = vector_to_move.Data();
+
+    SimpleVector<int> moved_vector = move(vector_to_move);
+    assert(moved_vector.GetSize() == size);
+    assert(vector_to_move.GetSize() == 0);
+    assert(moved_vector.Data() == items);
+
+    // присваивание в непустой вектор также перехватывает буфер
+    SimpleVector<int> target(10, 42);
+    target = move(moved_vector);
+    assert(target.GetSize() == size);
+    assert(target.Data() == items);
+    assert(target[0] == 1 && target[size - 1] == static_cast<int>(size));
+    assert(moved_vector.IsEmpty());
+    assert(moved_vector.GetCapacity() == 0);
+    cout << "Done!" << endl << endl;
+}
+
+void TestNoncopiableMoveConstructor() {
+    const size_t size = 5;
+    cout << "Test noncopiable object, move constructor" << endl;
+    SimpleVector<X> vector_to_move;
+    for (size_t i = 0; i < size; ++i) {
+        vector_to_move.PushBack(X(i));
+    }
+
+    SimpleVector<X> moved_vector = move(vector_to_move);
+    assert(moved_vector.GetSize() == size);
+    assert(vector_to_move.GetSize() == 0);
+
+    for (size_t i = 0; i < size; ++i) {
+        assert(moved_vector[i].GetX() == i);
+    }
+    cout << "Done!" << endl << endl;
+}
+
+void TestNoncopiablePushBack() {
+    const size_t size = 5;
+    cout << "Test noncopiable push back" << endl;
+    SimpleVector<X> v;
+    for (size_t i = 0; i < size; ++i) {
+        v.PushBack(X(i));
+    }
+
+    assert(v.GetSize() == size);
+
+    for (size_t i = 0; i < size; ++i) {
+        assert(v[i].GetX() == i);
+    }
+    cout << "Done!" << endl << endl;
+}
+
+void TestNoncopiableInsert() {
+    const size_t size = 5;
+    cout << "Test noncopiable insert" << endl;
+    SimpleVector<X> v;
+    for (size_t i = 0; i < size; ++i) {
+        v.PushBack(X(i));
+    }
+
+    // в начало
+    v.Insert(v.begin(), X(size + 1));
+    assert(v.GetSize() == size + 1);
+    assert(v.begin()->GetX() == size + 1);
+    // в конец
+    v.Insert(v.end(), X(size + 2));
+    assert(v.GetSize() == size + 2);
+    assert((v.end() - 1)->GetX() == size + 2);
+    // в середину
+    v.Insert(v.begin() + 3, X(size + 3));
+    assert(v.GetSize() == size + 3);
+    assert((v.begin() + 3)->GetX() == size + 3);
+    cout << "Done!" << endl << endl;
+}
+
+void TestNoncopiableErase() {
+    const size_t size = 3;
+    cout << "Test noncopiable erase" << endl;
+    SimpleVector<X> v;
+    for (size_t i = 0; i < size; ++i) {
+        v.PushBack(X(i));
+    }
+
+    [[maybe_unused]] auto it = v.Erase(v.begin());
+    assert(it->GetX() == 1);
+    cout << "Done!" << endl << endl;
+}
+
+void TestResizeMethodNoCopy() {
+    cout << "TestResizeMethodNoCopy"s << endl;
+    // создаем пустой вектор элементов с запрещённым копированием
+    SimpleVector<X> v;
+
+    // поместим 10 элементов в вектор
+    for (int i = 0; i < 10; ++i) {
+        v.PushBack(X(i));
+    }
+    assert(v.GetSize() == 10);
+
+    // увеличиваем размер в два раза
+    v.Resize(20);
+
+    assert(v.GetSize() == 20);
+
+    // проверяем, что первые 10 элементов не изменились
+    for (size_t i = 0; i < 10; ++i) {
+        assert(v[i].GetX() == i);
+    }
+
+    // проверяем, что следующие 10 элементов заполнились значением по-умолчанию
+    for (size_t i = 10; i < 20; ++i) {
+        assert(v[i].GetX() == 5);
+    }
+
+    // уменьшаем размер в 4 раза
+    v.Resize(5);
+
+    assert(v.GetSize() == 5);
+
+    // проверяем, что первые 5 элементов не изменились
+    for (size_t i = 0; i < 5; ++i) {
+        assert(v[i].GetX() == i);
+    }
+
+    // увеличиваем размер в два раза
+    v.Resize(10);
+
+    assert(v.GetSize() == 10);
+
+    // проверяем, что первые 5 элементов не изменились
+    for (size_t i = 0; i < 5; ++i) {
+        assert(v[i].GetX() == i);
+    }
+
+    // проверяем, что следующие 5 элементов заполнились значением по-умолчанию
+    for (size_t i = 5; i < 10; ++i) {
+        assert(v[i].GetX() == 5);
+    }
+    cout << "Done!"s << endl << endl;
+}
+
+// Тип без конструктора по умолчанию, подсчитывающий количество живых объектов
+class Counted {
+public:
+    explicit Counted(int value)
+        : value_(value) {
+        ++alive;
+    }
+    Counted(const Counted& other)
+        : value_(other.value_) {
+        ++alive;
+    }
+    Counted& operator=(const Counted& other) = default;
+    ~Counted() {
+        --alive;
+    }
+    int GetValue() const {
+        return value_;
+    }
+
+    inline static int alive = 0;
+
+private:
+    int value_;
+};
+
+void TestRawMemoryStorage() {
+    cout << "TestRawMemoryStorage"s << endl;
+    {
+        SimpleVector<Counted> v(Reserve(100));
+        assert(v.GetCapacity() == 100);
+        // резервирование не конструирует элементы
+        assert(Counted::alive == 0);
+
+        for (int i = 0; i < 10; ++i) {
+            v.PushBack(Counted(i));
+        }
+        assert(Counted::alive == 10);
+
+        v.Reserve(1000);
+        assert(v.GetCapacity() == 1000);
+        assert(Counted::alive == 10);
+
+        v.Insert(v.begin() + 5, Counted(100));
+        assert(Counted::alive == 11);
+        assert(v[5].GetValue() == 100 && v[6].GetValue() == 5);
+
+        v.Erase(v.begin());
+        assert(Counted::alive == 10);
+        v.PopBack();
+        assert(Counted::alive == 9);
+
+        SimpleVector<Counted> copy(v);
+        assert(Counted::alive == 18);
+        copy.Clear();
+        assert(Counted::alive == 9);
+    }
+    // все элементы разрушены вместе с вектором
+    assert(Counted::alive == 0);
+    cout << "Done!"s << endl << endl;
+}
+
+// Запись, конструируемая из нескольких полей
+struct Record {
+    Record(int id, string name)
+        : id(id)
+        , name(std::move(name)) {
+    }
+    Record(const Record&) = delete;
+    Record& operator=(const Record&) = delete;
+    Record(Record&&) = default;
+    Record& operator=(Record&&) = default;
+
+    int id;
+    string name;
+};
+
+// Тип, подсчитывающий живые объекты, присваивание перемещением которого бросает исключение по требованию
+struct ThrowingMoveAssign {
+    explicit ThrowingMoveAssign(int value = 0)
+        : value(value) {
+        ++alive;
+    }
+    ThrowingMoveAssign(ThrowingMoveAssign&& other)
+        : value(other.value) {
+        ++alive;
+    }
+    ThrowingMoveAssign& operator=(ThrowingMoveAssign&& other) {
+        if (assigns_until_throw >= 0 && assigns_until_throw-- == 0) {
+            throw runtime_error("move assignment failed"s);
+        }
+        value = other.value;
+        return *this;
+    }
+    ~ThrowingMoveAssign() {
+        --alive;
+    }
+
+    int value;
+    inline static int alive = 0;
+    inline static int assigns_until_throw = -1;
+};
+
+void TestEmplace() {
+    cout << "TestEmplace"s << endl;
+    SimpleVector<Record> v;
+    [[maybe_unused]] Record& first = v.EmplaceBack(1, "one"s);
+    assert(first.id == 1 && first.name == "one"s);
+    v.EmplaceBack(3, "three"s);
+    v.EmplaceBack(4, "four"s);
+    assert(v.GetSize() == 3);
+
+    // в середину
+    [[maybe_unused]] auto it = v.Emplace(v.cbegin() + 1, 2, "two"s);
+    assert(it == v.begin() + 1);
+    assert(it->id == 2 && it->name == "two"s);
+    // в начало, с перевыделением памяти
+    v.Emplace(v.cbegin(), 0, "zero"s);
+    // в конец
+    v.Emplace(v.cend(), 5, "five"s);
+    assert(v.GetSize() == 6);
+    for (int i = 0; i < 6; ++i) {
+        assert(v[i].id == i);
+    }
+    assert(v[5].name == "five"s);
+
+    // аргумент может ссылаться на элемент самого вектора
+    SimpleVector<string> strings{ "a"s, "b"s };
+    strings.Emplace(strings.cbegin(), strings[1]);
+    assert((strings == SimpleVector<string>{ "b"s, "a"s, "b"s }));
+    strings.EmplaceBack(strings[0]);
+    assert(strings[3] == "b"s);
+
+    // исключение при сдвиге "хвоста" не приводит к утечке элемента, перенесённого за конец вектора
+    {
+        SimpleVector<ThrowingMoveAssign> items;
+        items.Reserve(8);
+        for (int i = 0; i < 4; ++i) {
+            items.EmplaceBack(i);
+        }
+        for (int assigns : { 0, 2, 3 }) {
+            ThrowingMoveAssign::assigns_until_throw = assigns;
+            try {
+                items.Emplace(items.cbegin() + 1, 10);
+                assert(false);
+            }
+            catch (const runtime_error&) {
+            }
+            ThrowingMoveAssign::assigns_until_throw = -1;
+            assert(ThrowingMoveAssign::alive == static_cast<int>(items.GetSize()));
+        }
+    }
+    assert(ThrowingMoveAssign::alive == 0);
+    cout << "Done!"s << endl << endl;
+}
+
+// Тип, подсчитывающий вызовы конструктора перемещения.
+// Явно объявлен тривиально перемещаемым, поэтому вектор переносит его побайтово
+struct RelocatableTracked {
+    explicit RelocatableTracked(int value)
+        : value(make_unique<int>(value)) {
+    }
+    RelocatableTracked(RelocatableTracked&& other) noexcept
+        : value(std::move(other.value)) {
+        ++moves;
+    }
+    RelocatableTracked& operator=(RelocatableTracked&& other) noexcept {
+        value = std::move(other.value);
+        ++moves;
+        return *this;
+    }
+
+    unique_ptr<int> value;
+    inline static int moves = 0;
+};
+
+template <>
+struct IsTriviallyRelocatable<RelocatableTracked> : std::true_type {
+};
+
+// Тип, объявленный тривиально перемещаемым, конструктор перемещения которого бросает исключение по требованию
+struct RelocatableThrowingMove {
+    explicit RelocatableThrowingMove(int value)
+        : value(make_unique<int>(value)) {
+    }
+    RelocatableThrowingMove(RelocatableThrowingMove&& other)
+        : value(std::move(other.value)) {
+        if (moves_until_throw >= 0 && moves_until_throw-- == 0) {
+            other.value = std::move(value);
+            throw runtime_error("move failed"s);
+        }
+    }
+    RelocatableThrowingMove& operator=(RelocatableThrowingMove&&) = default;
+
+    unique_ptr<int> value;
+    inline static int moves_until_throw = -1;
+};
+
+template <>
+struct IsTriviallyRelocatable<RelocatableThrowingMove> : std::true_type {
+};
+
+void TestTriviallyRelocatable() {
+    cout << "TestTriviallyRelocatable"s << endl;
+    static_assert(IsTriviallyRelocatableV<int>);
+    static_assert(IsTriviallyRelocatableV<unique_ptr<int>>);
+    static_assert(!IsTriviallyRelocatableV<string>);
+    {
+        SimpleVector<int> v;
+        for (int i = 0; i < 100; ++i) {
+            v.PushBack(i);
+        }
+        v.Insert(v.begin() + 10, -1);
+        v.Insert(v.begin(), -2);
+        assert(v.GetSize() == 102);
+        assert(v[0] == -2 && v[1] == 0 && v[11] == -1 && v[12] == 10 && v[101] == 99);
+        v.Erase(v.begin() + 11);
+        v.Erase(v.begin());
+        SimpleVector<int> expected(100);
+        iota(expected.begin(), expected.end(), 0);
+        assert(v == expected);
+    }
+    {
+        SimpleVector<unique_ptr<int>> v;
+        for (int i = 0; i < 10; ++i) {
+            v.PushBack(make_unique<int>(i));
+        }
+        v.Reserve(100);
+        v.Insert(v.begin() + 5, make_unique<int>(100));
+        v.Erase(v.begin());
+        assert(v.GetSize() == 10);
+        assert(*v[0] == 1 && *v[4] == 100 && *v[9] == 9);
+    }
+    {
+        SimpleVector<RelocatableTracked> v;
+        for (int i = 0; i < 10; ++i) {
+            v.EmplaceBack(i);
+        }
+        // рост, вставка и удаление не вызывают конструктор перемещения для перенесённых элементов
+        RelocatableTracked::moves = 0;
+        v.Reserve(1000);
+        v.Emplace(v.cbegin() + 3, 100);
+        v.Erase(v.begin() + 3);
+        assert(RelocatableTracked::moves == 1);  // только перенос вставленного элемента из временного объекта
+        for (int i = 0; i < 10; ++i) {
+            assert(*v[i].value == i);
+        }
+    }
+    {
+        // исключение конструктора перемещения после сдвига "хвоста" возвращает "хвост" на место
+        SimpleVector<RelocatableThrowingMove> v;
+        v.Reserve(8);
+        for (int i = 0; i < 4; ++i) {
+            v.EmplaceBack(i);
+        }
+        RelocatableThrowingMove::moves_until_throw = 0;
+        try {
+            v.Emplace(v.cbegin() + 1, 100);
+            assert(false);
+        }
+        catch (const runtime_error&) {
+        }
+        RelocatableThrowingMove::moves_until_throw = -1;
+        assert(v.GetSize() == 4);
+        for (int i = 0; i < 4; ++i) {
+            assert(*v[i].value == i);
+        }
+    }
+    cout << "Done!"s << endl << endl;
+}
+
+void TestSmallVector() {
+    cout << "TestSmallVector"s << endl;
+    SmallVector<string, 4> v;
+    assert(v.IsInline() && v.GetCapacity() == 4);
+    for (int i = 0; i < 4; ++i) {
+        v.PushBack(to_string(i));
+    }
+    assert(v.IsInline());
+    assert((v == SmallVector<string, 4>{ "0"s, "1"s, "2"s, "3"s }));
+
+    // пятый элемент переносит вектор в кучу
+    v.Insert(v.begin() + 2, "x"s);
+    assert(!v.IsInline() && v.GetCapacity() == 8);
+    assert((v == SmallVector<string, 4>{ "0"s, "1"s, "x"s, "2"s, "3"s }));
+    assert(v.Erase(v.begin() + 2) == v.begin() + 2);
+    assert((v == SmallVector<string, 4>{ "0"s, "1"s, "2"s, "3"s }));
+
+    // копирование и перемещение для обоих режимов хранения
+    SmallVector<string, 4> small{ "a"s, "b"s };
+    SmallVector<string, 4> copy(v);
+    assert(copy == v);
+    SmallVector<string, 4> moved(std::move(copy));
+    assert(moved == v && copy.IsEmpty() && copy.IsInline());
+    moved = small;
+    assert(moved == small && moved.IsInline());
+    moved.swap(v);
+    assert(moved.GetSize() == 4 && v == small);
+    assert(moved < small);
+
+    v.Resize(10);
+    assert(v.GetSize() == 10 && v[1] == "b"s && v[9].empty());
+    v.Resize(1);
+    assert((v == SmallVector<string, 4>{ "a"s }));
+    assert(v.At(0) == "a"s);
+    try {
+        v.At(1);
+        assert(false);
+    }
+    catch (const out_of_range&) {
+    }
+    v.Clear();
+    assert(v.IsEmpty());
+
+    // вместимость в куче растёт согласно политике роста, как у SimpleVector
+    SmallVector<int, 4, OneAndHalfGrowth> grown;
+    for (int i = 0; i < 7; ++i) {
+        grown.PushBack(i);
+        assert(grown.GetCapacity() == (i < 4 ? 4u : i < 6 ? 6u : 9u));
+    }
+    grown.Insert(grown.begin(), -1);
+    grown.Insert(grown.begin(), -2);
+    assert(grown.GetSize() == 9 && grown.GetCapacity() == 9);
+    grown.Insert(grown.begin(), -3);
+    assert(grown.GetCapacity() == 13 && grown[0] == -3 && grown[9] == 6);
+    cout << "Done!"s << endl << endl;
+}
+
+template <typename Vector>
+size_t FillVectors(size_t count, int size) {
+    size_t total = 0;
+    for (size_t i = 0; i < count; ++i) {
+        Vector v;
+        for (int j = 0; j < size; ++j) {
+            v.PushBack(j);
+        }
+        total += v.GetSize();
+    }
+    return total;
+}
+
+void BenchmarkSmallVector() {
+    cout << "BenchmarkSmallVector"s << endl;
+    const size_t count = 100000;
+    size_t total = 0;
+    for (int size : { 0, 1, 2, 4, 8, 16, 32, 64 }) {
+        {
+            LOG_DURATION("SimpleVector<int>, size "s + to_string(size));
+            total += FillVectors<SimpleVector<int>>(count, size);
+        }
+        {
+            LOG_DURATION("SmallVector<int, 8>, size "s + to_string(size));
+            total += FillVectors<SmallVector<int, 8>>(count, size);
+        }
+    }
+    assert(total > 0);
+    cout << "Done!"s << endl << endl;
+}
+
+// Распределитель, подсчитывающий выделения памяти в общем счётчике
+template <typename Type>
+struct CountingAllocator {
+    using value_type = Type;
+
+    explicit CountingAllocator(size_t* allocations) noexcept
+        : allocations(allocations) {
+    }
+
+    template <typename Other>
+    CountingAllocator(const CountingAllocator<Other>& other) noexcept
+        : allocations(other.allocations) {
+    }
+
+    Type* allocate(size_t n) {
+        ++*allocations;
+        return std::allocator<Type>().allocate(n);
+    }
+
+    void deallocate(Type* p, size_t n) noexcept {
+        std::allocator<Type>().deallocate(p, n);
+    }
+
+    template <typename Other>
+    bool operator==(const CountingAllocator<Other>& other) const noexcept {
+        return allocations == other.allocations;
+    }
+
+    template <typename Other>
+    bool operator!=(const CountingAllocator<Other>& other) const noexcept {
+        return !(*this == other);
+    }
+
+    size_t* allocations;
+};
+
+// Распределитель, передаваемый при копирующем присваивании контейнера
+template <typename Type>
+struct PropagatingAllocator : CountingAllocator<Type> {
+    using propagate_on_container_copy_assignment = std::true_type;
+    using CountingAllocator<Type>::CountingAllocator;
+};
+
+void TestCustomAllocator() {
+    cout << "TestCustomAllocator"s << endl;
+    size_t allocations = 0;
+    using Alloc = CountingAllocator<string>;
+    {
+        SimpleVector<string, Alloc> v(Alloc{ &allocations });
+        for (int i = 0; i < 10; ++i) {
+            v.PushBack(to_string(i));
+        }
+        // 1, 2, 4, 8, 16
+        assert(allocations == 5);
+        v.Insert(v.begin(), "x"s);
+        v.Resize(20);
+        v.Reserve(100);
+        assert(allocations == 7);
+
+        SimpleVector<string, Alloc> copy(v);
+        assert(allocations == 8);
+        assert(copy == v);
+        assert(copy.GetAllocator() == v.GetAllocator());
+
+        SimpleVector<string, Alloc> moved(std::move(copy));
+        assert(allocations == 8);
+        assert(moved == v);
+    }
+    {
+        // пустой распределитель не увеличивает размер ArrayPtr
+        static_assert(sizeof(ArrayPtr<int, true>) == sizeof(int*) + sizeof(size_t));
+
+        // при propagate_on_container_copy_assignment вектор получает распределитель источника
+        size_t source_allocations = 0;
+        size_t target_allocations = 0;
+        using Propagating = PropagatingAllocator<string>;
+        SimpleVector<string, Propagating> source(Propagating{ &source_allocations });
+        source.PushBack("a"s);
+        SimpleVector<string, Propagating> target(Propagating{ &target_allocations });
+        target.PushBack("b"s);
+        target = source;
+        assert(target == source && target.GetAllocator() == source.GetAllocator());
+        assert(source_allocations == 2 && target_allocations == 1);
+
+        const SimpleVector<string, Propagating> empty_source(Propagating{ &source_allocations });
+        SimpleVector<string, Propagating> other_target(Propagating{ &target_allocations });
+        other_target.PushBack("c"s);
+        other_target = empty_source;
+        assert(other_target.IsEmpty() && other_target.GetAllocator() == empty_source.GetAllocator());
+    }
+
+    std::array<std::byte, 4096> buffer;
+    std::pmr::monotonic_buffer_resource resource(buffer.data(), buffer.size(), std::pmr::null_memory_resource());
+    using PmrVector = SimpleVector<std::pmr::string, std::pmr::polymorphic_allocator<std::pmr::string>>;
+    PmrVector v(&resource);
+    for (int i = 0; i < 10; ++i) {
+        v.EmplaceBack(to_string(i));
+    }
+    v.Insert(v.begin() + 5, std::pmr::string("y"));
+    v.Resize(12);
+    // элементы получают ресурс памяти вектора
+    for ([[maybe_unused]] const auto& item : v) {
+        assert(item.get_allocator().resource() == &resource);
+    }
+
+    PmrVector other(&resource);
+    other = v;
+    assert(other == v);
+    other = std::move(v);
+    assert(other.GetSize() == 12 && v.IsEmpty());
+    cout << "Done!"s << endl << endl;
+}
+
+template <typename Vector>
+SimpleVector<size_t> CollectCapacities(size_t count) {
+    Vector v;
+    SimpleVector<size_t> capacities;
+    for (size_t i = 0; i < count; ++i) {
+        v.PushBack(0);
+        if (capacities.IsEmpty() || capacities[capacities.GetSize() - 1] != v.GetCapacity()) {
+            capacities.PushBack(v.GetCapacity());
+        }
+    }
+    return capacities;
+}
+
+void TestGrowthPolicy() {
+    cout << "TestGrowthPolicy"s << endl;
+    using Doubling [[maybe_unused]] = SimpleVector<int, std::allocator<int>, DoublingGrowth>;
+    using OneAndHalf = SimpleVector<int, std::allocator<int>, OneAndHalfGrowth>;
+    using Clamped [[maybe_unused]] = SimpleVector<int, std::allocator<int>, ClampedGrowth<4>>;
+
+    assert((CollectCapacities<Doubling>(20) == SimpleVector<size_t>{ 1, 2, 4, 8, 16, 32 }));
+    assert((CollectCapacities<OneAndHalf>(20) == SimpleVector<size_t>{ 1, 2, 3, 4, 6, 9, 13, 19, 28 }));
+    assert((CollectCapacities<Clamped>(20) == SimpleVector<size_t>{ 1, 2, 4, 8, 12, 16, 20 }));
+
+    // политика применяется одинаково в Insert и Resize
+    OneAndHalf v(4);
+    v.Insert(v.begin(), 1);
+    assert(v.GetCapacity() == 6);
+    v.Resize(7);
+    assert(v.GetCapacity() == 9);
+    // при нехватке вместимости, рассчитанной политикой, выделяется ровно требуемое количество
+    v.Resize(100);
+    assert(v.GetCapacity() == 100);
+    cout << "Done!"s << endl << endl;
+}
+
+// Статистика выделений памяти: текущий и пиковый объём выделенной памяти в байтах
+struct MemoryStats {
+    size_t current = 0;
+    size_t peak = 0;
+};
+
+// Распределитель, отслеживающий пиковый объём выделенной памяти
+template <typename Type>
+struct PeakTrackingAllocator {
+    using value_type = Type;
+
+    explicit PeakTrackingAllocator(MemoryStats* stats) noexcept
+        : stats(stats) {
+    }
+
+    template <typename Other>
+    PeakTrackingAllocator(const PeakTrackingAllocator<Other>& other) noexcept
+        : stats(other.stats) {
+    }
+
+    Type* allocate(size_t n) {
+        stats->current += n * sizeof(Type);
+        stats->peak = std::max(stats->peak, stats->current);
+        return std::allocator<Type>().allocate(n);
+    }
+
+    void deallocate(Type* p, size_t n) noexcept {
+        stats->current -= n * sizeof(Type);
+        std::allocator<Type>().deallocate(p, n);
+    }
+
+    template <typename Other>
+    bool operator==(const PeakTrackingAllocator<Other>& other) const noexcept {
+        return stats == other.stats;
+    }
+
+    template <typename Other>
+    bool operator!=(const PeakTrackingAllocator<Other>& other) const noexcept {
+        return !(*this == other);
+    }
+
+    MemoryStats* stats;
+};
+
+template <typename GrowthPolicy>
+void BenchmarkGrowthPolicy(const string& name, size_t count) {
+    MemoryStats stats;
+    {
+        LOG_DURATION(name);
+        SimpleVector<int, PeakTrackingAllocator<int>, GrowthPolicy> v(PeakTrackingAllocator<int>{ &stats });
+        for (size_t i = 0; i < count; ++i) {
+            v.PushBack(static_cast<int>(i));
+        }
+        assert(v.GetSize() == count);
+    }
+    cerr << name << " peak memory: "s << stats.peak / (1024 * 1024) << " MB"s << endl;
+}
+
+void BenchmarkGrowthPolicies() {
+    cout << "BenchmarkGrowthPolicies"s << endl;
+    const size_t count = 10'000'000;
+    BenchmarkGrowthPolicy<DoublingGrowth>("DoublingGrowth"s, count);
+    BenchmarkGrowthPolicy<OneAndHalfGrowth>("OneAndHalfGrowth"s, count);
+    BenchmarkGrowthPolicy<ClampedGrowth<(1 << 20)>>("ClampedGrowth<1M>"s, count);
+    cout << "Done!"s << endl << endl;
+}
+
+void TestShrinkToFit() {
+    cout << "TestShrinkToFit"s << endl;
+    {
+        SimpleVector<Counted> v;
+        for (int i = 0; i < 10; ++i) {
+            v.EmplaceBack(i);
+        }
+        // элементы разрушаются сразу при выходе из диапазона [0, size)
+        v.PopBack();
+        assert(Counted::alive == 9);
+        while (v.GetSize() > 5) {
+            v.PopBack();
+        }
+        assert(Counted::alive == 5);
+        assert(v.GetCapacity() == 16);
+
+        v.ShrinkToFit();
+        assert(v.GetCapacity() == 5 && v.GetSize() == 5);
+        assert(Counted::alive == 5);
+        for (int i = 0; i < 5; ++i) {
+            assert(v[i].GetValue() == i);
+        }
+
+        v.Clear();
+        assert(Counted::alive == 0);
+        v.ShrinkToFit();
+        assert(v.GetCapacity() == 0 && v.Data() == nullptr);
+    }
+    {
+        auto shared = make_shared<int>(0);
+        SimpleVector<shared_ptr<int>> v(10, shared);
+        assert(shared.use_count() == 11);
+        v.Resize(3);
+        assert(shared.use_count() == 4);
+        v.Clear();
+        assert(shared.use_count() == 1);
+    }
+    {
+        MemoryStats stats;
+        SimpleVector<string, PeakTrackingAllocator<string>> v(PeakTrackingAllocator<string>{ &stats });
+        for (int i = 0; i < 1000; ++i) {
+            v.PushBack(string(100, 'a'));
+        }
+        v.Resize(10);
+        v.ShrinkToFit();
+        // память буфера возвращена распределителю
+        assert(stats.current == 10 * sizeof(string));
+        assert(v[9] == string(100, 'a'));
+    }
+    cout << "Done!"s << endl << endl;
+}
+
+void TestRangeOperations() {
+    cout << "TestRangeOperations"s << endl;
+    {
+        SimpleVector<int> v{ 1, 2, 3, 4, 5 };
+        const int values[] = { 10, 11, 12 };
+        // вставка в середину без перевыделения памяти
+        v.Reserve(20);
+        [[maybe_unused]] auto it = v.InsertRange(v.cbegin() + 2, begin(values), end(values));
+        assert(it == v.begin() + 2);
+        assert((v == SimpleVector<int>{ 1, 2, 10, 11, 12, 3, 4, 5 }));
+        // вставка с перевыделением памяти
+        SimpleVector<int> many(30, 7);
+        v.InsertRange(v.cbegin() + 1, many.begin(), many.end());
+        assert(v.GetSize() == 38 && v[0] == 1 && v[1] == 7 && v[30] == 7 && v[31] == 2 && v[37] == 5);
+
+        it = v.EraseRange(v.cbegin() + 1, v.cbegin() + 31);
+        assert(it == v.begin() + 1);
+        assert((v == SimpleVector<int>{ 1, 2, 10, 11, 12, 3, 4, 5 }));
+        it = v.EraseRange(v.cbegin() + 5, v.cend());
+        assert(it == v.end());
+        assert((v == SimpleVector<int>{ 1, 2, 10, 11, 12 }));
+    }
+    {
+        // для типов, не перемещаемых побайтово, проверяем обе ветви сдвига "хвоста"
+        SimpleVector<string> v{ "a"s, "b"s, "c"s, "d"s };
+        v.Reserve(20);
+        SimpleVector<string> one{ "x"s };
+        v.InsertRange(v.cbegin() + 1, one.begin(), one.end());
+        assert((v == SimpleVector<string>{ "a"s, "x"s, "b"s, "c"s, "d"s }));
+        SimpleVector<string> many{ "1"s, "2"s, "3"s, "4"s, "5"s };
+        v.InsertRange(v.cbegin() + 3, many.begin(), many.end());
+        assert((v == SimpleVector<string>{ "a"s, "x"s, "b"s, "1"s, "2"s, "3"s, "4"s, "5"s, "c"s, "d"s }));
+        v.EraseRange(v.cbegin() + 1, v.cbegin() + 8);
+        assert((v == SimpleVector<string>{ "a"s, "c"s, "d"s }));
+
+        v.Assign({ "p"s, "q"s });
+        assert((v == SimpleVector<string>{ "p"s, "q"s }));
+        v.AppendRange(many.begin(), many.begin() + 2);
+        assert((v == SimpleVector<string>{ "p"s, "q"s, "1"s, "2"s }));
+    }
+    {
+        // однопроходный диапазон
+        istringstream input("1 2 3"s);
+        SimpleVector<int> v{ 0, 4 };
+        v.InsertRange(v.cbegin() + 1, istream_iterator<int>(input), istream_iterator<int>());
+        assert((v == SimpleVector<int>{ 0, 1, 2, 3, 4 }));
+    }
+#if defined(__cpp_lib_ranges)
+    {
+        SimpleVector<int> v;
+        v.AppendRange(std::views::iota(0, 5));
+        assert((v == SimpleVector<int>{ 0, 1, 2, 3, 4 }));
+        v.InsertRange(v.cbegin(), std::views::iota(0) | std::views::take_while([](int x) { return x < 2; }));
+        assert((v == SimpleVector<int>{ 0, 1, 0, 1, 2, 3, 4 }));
+        const SimpleVector<int> source{ 1, 2, 3, 4 };
+        v.Assign(source | std::views::filter([](int x) { return x > 2; }));
+        assert((v == SimpleVector<int>{ 3, 4 }));
+    }
+#endif
+    cout << "Done!"s << endl << endl;
+}
+
+void BenchmarkRangeInsert() {
+    cout << "BenchmarkRangeInsert"s << endl;
+    const size_t size = 100'000;
+    const size_t count = 10'000;
+    SimpleVector<int> values(count, 1);
+    {
+        SimpleVector<int> v(size);
+        LOG_DURATION("Repeated Insert of 10000 ints"s);
+        auto pos = v.begin() + size / 2;
+        for (int value : values) {
+            pos = v.Insert(pos, value) + 1;
+        }
+        assert(v.GetSize() == size + count);
+    }
+    {
+        SimpleVector<int> v(size);
+        LOG_DURATION("InsertRange of 10000 ints"s);
+        v.InsertRange(v.cbegin() + size / 2, values.begin(), values.end());
+        assert(v.GetSize() == size + count);
+    }
+    cout << "Done!"s << endl << endl;
+}
+
+// Тип с бросающим конструктором перемещения и копированием, которое бросает исключение по требованию
+struct MayThrow {
+    explicit MayThrow(int value)
+        : value(value) {
+    }
+    MayThrow(const MayThrow& other)
+        : value(other.value) {
+        if (copies_until_throw >= 0 && copies_until_throw-- == 0) {
+            throw runtime_error("copy failed"s);
+        }
+        ++copies;
+    }
+    MayThrow(MayThrow&& other)  // не noexcept
+        : value(other.value) {
+        other.value = -1;
+        ++moves;
+    }
+    MayThrow& operator=(const MayThrow&) = default;
+    MayThrow& operator=(MayThrow&&) = default;
+
+    int value;
+    inline static int copies = 0;
+    inline static int moves = 0;
+    inline static int copies_until_throw = -1;
+};
+
+// Тип с небросающим перемещением, который не переносится побайтово
+struct NothrowMove {
+    explicit NothrowMove(string value)
+        : value(std::move(value)) {
+    }
+    NothrowMove(const NothrowMove& other)
+        : value(other.value) {
+        ++copies;
+    }
+    NothrowMove(NothrowMove&& other) noexcept = default;
+    NothrowMove& operator=(const NothrowMove&) = default;
+    NothrowMove& operator=(NothrowMove&&) noexcept = default;
+
+    string value;
+    inline static int copies = 0;
+};
+
+void TestGrowthExceptionSafety() {
+    cout << "TestGrowthExceptionSafety"s << endl;
+    SimpleVector<MayThrow> v;
+    v.Reserve(4);
+    for (int i = 0; i < 4; ++i) {
+        v.EmplaceBack(i);
+    }
+    [[maybe_unused]] const MayThrow* items = v.Data();
+
+    // перемещение может бросить, поэтому при росте элементы копируются; сбой копирования не портит вектор
+    MayThrow::copies_until_throw = 2;
+    try {
+        v.EmplaceBack(4);
+        assert(false);
+    }
+    catch (const runtime_error&) {
+    }
+    MayThrow::copies_until_throw = -1;
+    assert(v.GetSize() == 4 && v.GetCapacity() == 4 && v.Data() == items);
+    for (int i = 0; i < 4; ++i) {
+        assert(v[i].value == i);
+    }
+
+    // то же для вставки в середину и Reserve
+    MayThrow::copies_until_throw = 3;
+    try {
+        v.Emplace(v.cbegin() + 1, 10);
+        assert(false);
+    }
+    catch (const runtime_error&) {
+    }
+    MayThrow::copies_until_throw = 0;
+    try {
+        v.Reserve(100);
+        assert(false);
+    }
+    catch (const runtime_error&) {
+    }
+    MayThrow::copies_until_throw = -1;
+    assert(v.GetSize() == 4 && v.Data() == items);
+    for (int i = 0; i < 4; ++i) {
+        assert(v[i].value == i);
+    }
+
+    MayThrow::moves = 0;
+    v.Reserve(100);
+    assert(MayThrow::moves == 0);
+
+    // при небросающем перемещении копирование не выполняется
+    SimpleVector<NothrowMove> nothrow;
+    for (int i = 0; i < 100; ++i) {
+        nothrow.EmplaceBack(to_string(i));
+    }
+    nothrow.Emplace(nothrow.cbegin(), "x"s);
+    assert(NothrowMove::copies == 0);
+    assert(nothrow[0].value == "x"s && nothrow[100].value == "99"s);
+    cout << "Done!"s << endl << endl;
+}
+
+template <typename Type>
+void CheckComparisonsMatchStd([[maybe_unused]] const SimpleVector<Type>& lhs, [[maybe_unused]] const SimpleVector<Type>& rhs) {
+    assert((lhs == rhs) == std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end()));
+    assert((lhs < rhs) == std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end()));
+    assert((rhs < lhs) == std::lexicographical_compare(rhs.begin(), rhs.end(), lhs.begin(), lhs.end()));
+}
+
+// Перечисление с собственным сравнением, в котором все значения эквивалентны
+enum class AnyColor {
+    RED,
+    GREEN,
+};
+
+bool operator==(AnyColor, AnyColor) noexcept {
+    return true;
+}
+
+bool operator<(AnyColor, AnyColor) noexcept {
+    return false;
+}
+
+template <typename Type>
+void CheckArithmeticComparisons() {
+    // различие в каждой позиции для размеров, не кратных ширине SIMD-регистра
+    for (size_t size : { 0, 1, 7, 16, 33, 100 }) {
+        SimpleVector<Type> base(size);
+        for (size_t i = 0; i < size; ++i) {
+            base[i] = static_cast<Type>(i % 7) - static_cast<Type>(3);
+        }
+        CheckComparisonsMatchStd(base, base);
+        for (size_t i = 0; i < size; ++i) {
+            SimpleVector<Type> other(base);
+            other[i] = other[i] + static_cast<Type>(1);
+            CheckComparisonsMatchStd(base, other);
+            other[i] = other[i] - static_cast<Type>(2);
+            CheckComparisonsMatchStd(base, other);
+        }
+        // более длинный вектор создаётся сразу нужного размера: последний элемент равен Type{}
+        SimpleVector<Type> longer(size + 1);
+        std::copy(base.begin(), base.end(), longer.begin());
+        CheckComparisonsMatchStd(base, longer);
+    }
+}
+
+void TestSimdComparisons() {
+    cout << "TestSimdComparisons"s << endl;
+    CheckArithmeticComparisons<char>();
+    CheckArithmeticComparisons<unsigned char>();
+    CheckArithmeticComparisons<short>();
+    CheckArithmeticComparisons<int>();
+    CheckArithmeticComparisons<unsigned>();
+    CheckArithmeticComparisons<int64_t>();
+    CheckArithmeticComparisons<float>();
+    CheckArithmeticComparisons<double>();
+
+    // семантика operator== и operator< для NaN и нулей разного знака совпадает со стандартными алгоритмами
+    const double nan = numeric_limits<double>::quiet_NaN();
+    SimpleVector<double> with_nan{ 1.0, nan, 2.0, 3.0, 4.0 };
+    SimpleVector<double> zeros{ 0.0, 0.0, 0.0, 0.0, 0.0 };
+    SimpleVector<double> negative_zeros{ -0.0, -0.0, -0.0, -0.0, -0.0 };
+    CheckComparisonsMatchStd(with_nan, with_nan);
+    SimpleVector<double> other_nan{ 1.0, nan, 2.0, 3.0, 5.0 };
+    CheckComparisonsMatchStd(with_nan, other_nan);
+    assert(zeros == negative_zeros);
+    CheckComparisonsMatchStd(zeros, negative_zeros);
+
+    // для перечислений вызываются их собственные операторы, а не memcmp
+    const SimpleVector<AnyColor> red{ AnyColor::RED, AnyColor::RED };
+    const SimpleVector<AnyColor> green{ AnyColor::GREEN, AnyColor::GREEN };
+    assert(red == green && !(red < green) && !(green < red));
+    cout << "Done!"s << endl << endl;
+}
+
+void BenchmarkComparisons() {
+    cout << "BenchmarkComparisons"s << endl;
+    const size_t size = 10'000'000;
+    SimpleVector<int> lhs(size);
+    iota(lhs.begin(), lhs.end(), 0);
+    SimpleVector<int> rhs(lhs);
+    rhs[size - 1] = -1;
+    SimpleVector<double> lhs_double(size, 1.5);
+    SimpleVector<double> rhs_double(lhs_double);
+    rhs_double[size - 1] = 2.0;
+
+    bool result = false;
+    {
+        LOG_DURATION("std::lexicographical_compare, int"s);
+        result ^= std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+    {
+        LOG_DURATION("SimpleVector operator<, int"s);
+        result ^= lhs < rhs;
+    }
+    {
+        LOG_DURATION("std::equal, double"s);
+        result ^= std::equal(lhs_double.begin(), lhs_double.end(), rhs_double.begin());
+    }
+    {
+        LOG_DURATION("SimpleVector operator==, double"s);
+        result ^= lhs_double == rhs_double;
+    }
+    {
+        LOG_DURATION("std::lexicographical_compare, double"s);
+        result ^= std::lexicographical_compare(lhs_double.begin(), lhs_double.end(), rhs_double.begin(), rhs_double.end());
+    }
+    {
+        LOG_DURATION("SimpleVector operator<, double"s);
+        result ^= lhs_double < rhs_double;
+    }
+    assert(!result);
+    cout << "Done!"s << endl << endl;
+}
+
+// Тип, конструктор по умолчанию которого бросает исключение на заданном по счёту объекте
+struct ThrowingDefault {
+    ThrowingDefault() {
+        if (constructions_until_throw.fetch_sub(1) == 0) {
+            throw runtime_error("construction failed"s);
+        }
+        ++alive;
+    }
+    ThrowingDefault(const ThrowingDefault&) {
+        ++alive;
+    }
+    ~ThrowingDefault() {
+        --alive;
+    }
+
+    inline static atomic<int> alive = 0;
+    inline static atomic<long long> constructions_until_throw = -1;
+};
+
+void TestParallelConstruction() {
+    cout << "TestParallelConstruction"s << endl;
+    const size_t size = 1000000;
+    const ParallelInit parallel{ 4, 1000 };
+
+    SimpleVector<int> zeros(size, parallel);
+    assert(zeros.GetSize() == size);
+    assert(all_of(zeros.begin(), zeros.end(), [](int x) { return x == 0; }));
+
+    SimpleVector<string> strings(size, "abc"s, parallel);
+    assert(all_of(strings.begin(), strings.end(), [](const string& s) { return s == "abc"s; }));
+
+    // Resize с ростом вместимости и в пределах вместимости
+    SimpleVector<int> v{ 1, 2, 3 };
+    v.Resize(size, parallel);
+    assert(v[0] == 1 && v[2] == 3 && v[3] == 0 && v[size - 1] == 0);
+    v.Resize(10);
+    v.Resize(size, parallel);
+    assert(v.GetSize() == size && v[size - 1] == 0);
+
+    // ниже порога элементы конструируются последовательно
+    SimpleVector<int> small(10, 7, parallel);
+    assert((small == SimpleVector<int>(10, 7)));
+
+    // исключение в одном из потоков не оставляет живых объектов
+    ThrowingDefault::constructions_until_throw = size / 2;
+    try {
+        SimpleVector<ThrowingDefault> failed(size, parallel);
+        assert(false);
+    }
+    catch (const runtime_error&) {
+    }
+    assert(ThrowingDefault::alive == 0);
+    ThrowingDefault::constructions_until_throw = -1;
+
+    // распределитель с состоянием не разделяется между потоками: элементы конструируются последовательно
+    pmr::monotonic_buffer_resource resource;
+    SimpleVector<pmr::string, pmr::polymorphic_allocator<pmr::string>> pmr_strings(
+        size, pmr::string("abc"), parallel, pmr::polymorphic_allocator<pmr::string>(&resource));
+    assert(pmr_strings[size - 1] == "abc" && pmr_strings[0].get_allocator().resource() == &resource);
+
+    // повторные вызовы переиспользуют потоки пула
+    for (int i = 0; i < 10; ++i) {
+        SimpleVector<int> repeated(size, i, parallel);
+        assert(repeated[0] == i && repeated[size - 1] == i);
+    }
+
+    // элементы создаются рабочими потоками пула, а не вызывающим потоком
+    struct ThreadTag {
+        std::thread::id id = std::this_thread::get_id();
+    };
+    const SimpleVector<ThreadTag> tags(size, parallel);
+    assert(none_of(tags.begin(), tags.end(), [](const ThreadTag& tag) { return tag.id == std::this_thread::get_id(); }));
+
+    // параллельное конструирование внутри задачи пула не блокирует пул
+    ThreadPool& pool = ThreadPool::Shared();
+    std::future<void> nested = pool.Submit([&parallel] {
+        SimpleVector<int> inner(size, 5, parallel);
+        assert(inner[size - 1] == 5);
+    });
+    pool.Wait(nested);
+    nested.get();
+    cout << "Done!"s << endl << endl;
+}
+
+void BenchmarkParallelConstruction() {
+    cout << "BenchmarkParallelConstruction"s << endl;
+    const size_t size = 50'000'000;
+    {
+        LOG_DURATION("Serial construction of 50M ints"s);
+        SimpleVector<int> v(size, 1);
+        assert(v[size - 1] == 1);
+    }
+    {
+        LOG_DURATION("Parallel construction of 50M ints"s);
+        SimpleVector<int> v(size, 1, ParallelInit{});
+        assert(v[size - 1] == 1);
+    }
+    cout << "Done!"s << endl << endl;
+}
+
+void TestAlignedAllocation() {
+    cout << "TestAlignedAllocation"s << endl;
+    {
+        SimpleVector<float, AlignedAllocator<float, 64>> v;
+        for (int i = 0; i < 1000; ++i) {
+            v.PushBack(static_cast<float>(i));
+            assert(reinterpret_cast<uintptr_t>(v.Data()) % 64 == 0);
+        }
+        assert(v[999] == 999.0f);
+    }
+    {
+        // маленький вектор выделяется в куче, большой - в отображении, выровненном по огромной странице
+        SimpleVector<int, HugePageAllocator<int>> small(100, 1);
+        assert(reinterpret_cast<uintptr_t>(small.Data()) % 64 == 0);
+
+        const size_t size = 3 * HUGE_PAGE_SIZE / sizeof(int);
+        SimpleVector<int, HugePageAllocator<int>> large(size);
+        iota(large.begin(), large.end(), 0);
+#ifdef SIMPLE_VECTOR_HAS_MMAP
+        assert(reinterpret_cast<uintptr_t>(large.Data()) % HUGE_PAGE_SIZE == 0);
+#endif
+        large.PushBack(-1);
+        assert(large[size - 1] == static_cast<int>(size - 1) && large[size] == -1);
+        large.ShrinkToFit();
+        large.Resize(10);
+        large.ShrinkToFit();
+        assert(large.GetCapacity() == 10 && large[9] == 9);
+    }
+    {
+        // размер блока в байтах не должен переполнять size_t
+        const size_t huge_count = std::numeric_limits<size_t>::max() / 2;
+        try {
+            [[maybe_unused]] double* p = AlignedAllocator<double, 64>().allocate(huge_count);
+            assert(false);
+        }
+        catch (const bad_array_new_length&) {
+        }
+        try {
+            [[maybe_unused]] double* p = HugePageAllocator<double>().allocate(huge_count);
+            assert(false);
+        }
+        catch (const bad_array_new_length&) {
+        }
+    }
+    cout << "Done!"s << endl << endl;
+}
+
+#ifdef SIMPLE_VECTOR_HAS_MMAP
+// Запись фиксированного размера для хранения в файле
+struct Trade {
+    int64_t id;
+    double price;
+    int32_t qty;
+};
+
+void TestMappedVector() {
+    cout << "TestMappedVector"s << endl;
+    const string path = (std::filesystem::temp_directory_path() / "simple_vector_mapped_test.bin"s).string();
+    std::filesystem::remove(path);
+    const int count = 100000;
+    {
+        MappedVector<Trade> trades(path, MapMode::ReadWrite);
+        assert(trades.IsEmpty());
+        for (int i = 0; i < count; ++i) {
+            trades.PushBack({ i, i * 0.5, i % 100 });
+        }
+        trades.Flush();
+    }
+    // файл содержит ровно count записей
+    assert(std::filesystem::file_size(path) == count * sizeof(Trade));
+    {
+        const MappedVector<Trade> trades(path, MapMode::ReadOnly);
+        assert(trades.GetSize() == static_cast<size_t>(count));
+        for (int i = 0; i < count; ++i) {
+            assert(trades[i].id == i && trades[i].price == i * 0.5 && trades[i].qty == i % 100);
+        }
+    }
+    {
+        // изменения в режиме только для чтения не попадают в файл, рост запрещён
+        MappedVector<Trade> trades(path, MapMode::ReadOnly);
+        trades[0].qty = -1;
+        try {
+            trades.PushBack({});
+            assert(false);
+        }
+        catch (const logic_error&) {
+        }
+    }
+    {
+        MappedVector<Trade> trades(path, MapMode::ReadWrite);
+        assert(trades[0].qty == 0);
+        trades[0].qty = 42;
+        trades.Resize(count + 10);
+        assert(trades[count + 9].id == 0);
+        trades.PopBack();
+    }
+    {
+        MappedVector<Trade> trades(path, MapMode::ReadOnly);
+        assert(trades.GetSize() == static_cast<size_t>(count + 9));
+        assert(trades.At(0).qty == 42);
+        MappedVector<Trade> moved(std::move(trades));
+        assert(moved[count - 1].id == count - 1);
+    }
+    std::filesystem::remove(path);
+    try {
+        MappedVector<Trade> missing(path, MapMode::ReadOnly);
+        assert(false);
+    }
+    catch (const system_error&) {
+    }
+
+    // файл с неполным последним элементом не открывается для записи и не обрезается
+    {
+        ofstream file(path, ios::binary);
+        file.write("12345", 5);
+    }
+    try {
+        MappedVector<int> partial(path, MapMode::ReadWrite);
+        assert(false);
+    }
+    catch (const runtime_error&) {
+    }
+    assert(std::filesystem::file_size(path) == 5);
+    {
+        const MappedVector<int> partial(path, MapMode::ReadOnly);
+        assert(partial.GetSize() == 1);
+    }
+    std::filesystem::remove(path);
+    cout << "Done!"s << endl << endl;
+}
+#endif
+
+void TestBinarySerialization() {
+    cout << "TestBinarySerialization"s << endl;
+    SimpleVector<double> v(1001);
+    for (size_t i = 0; i < v.GetSize(); ++i) {
+        v[i] = i * 0.25;
+    }
+
+    stringstream stream;
+    v.WriteBinary(stream);
+    const string data = stream.str();
+    assert(data.size() == sizeof(BinaryHeader) + v.GetSize() * sizeof(double));
+
+    const auto restored = SimpleVector<double>::ReadBinary(stream);
+    assert(restored == v);
+
+    // данные читаются без копирования
+    const BinaryView<double> view(data.data(), data.size());
+    assert(view.GetSize() == v.GetSize());
+    assert(std::equal(view.begin(), view.end(), v.begin()));
+
+    // пустой вектор
+    stringstream empty_stream;
+    SimpleVector<int>().WriteBinary(empty_stream);
+    assert(SimpleVector<int>::ReadBinary(empty_stream).IsEmpty());
+
+    auto expect_error = [](const string& bytes, auto read) {
+        try {
+            read(bytes);
+            assert(false);
+        }
+        catch (const runtime_error&) {
+        }
+    };
+    auto read_doubles = [](const string& bytes) {
+        istringstream input(bytes);
+        return SimpleVector<double>::ReadBinary(input);
+    };
+    string corrupted = data;
+    corrupted[sizeof(BinaryHeader) + 100] ^= 1;
+    expect_error(corrupted, read_doubles);
+    expect_error(data.substr(0, data.size() - 1), read_doubles);
+    expect_error("garbage"s, read_doubles);
+    expect_error(data, [](const string& bytes) {
+        istringstream input(bytes);
+        return SimpleVector<float>::ReadBinary(input);
+    });
+    expect_error(corrupted, [](const string& bytes) {
+        return BinaryView<double>(bytes.data(), bytes.size()).GetSize();
+    });
+
+    // заголовок с огромным количеством элементов отвергается до выделения памяти
+    string huge = data;
+    const uint64_t huge_count = uint64_t(1) << 40;
+    std::memcpy(huge.data() + offsetof(BinaryHeader, count), &huge_count, sizeof(huge_count));
+    expect_error(huge, read_doubles);
+
+    // поток без позиционирования читается частями
+    struct NonSeekableBuffer : std::streambuf {
+        explicit NonSeekableBuffer(string& bytes) {
+            setg(bytes.data(), bytes.data(), bytes.data() + bytes.size());
+        }
+    };
+    auto read_non_seekable = [](string bytes) {
+        NonSeekableBuffer buffer(bytes);
+        istream input(&buffer);
+        return SimpleVector<double>::ReadBinary(input);
+    };
+    SimpleVector<double> large(100000);
+    std::iota(large.begin(), large.end(), 0.0);
+    stringstream large_stream;
+    large.WriteBinary(large_stream);
+    assert(read_non_seekable(large_stream.str()) == large);
+    expect_error(huge, read_non_seekable);
+
+#ifdef SIMPLE_VECTOR_HAS_MMAP
+    const string path = (std::filesystem::temp_directory_path() / "simple_vector_binary_test.bin"s).string();
+    {
+        ofstream file(path, ios::binary);
+        v.WriteBinary(file);
+    }
+    {
+        const MappedBinaryFile<double> mapped(path);
+        assert(mapped.View().GetSize() == v.GetSize());
+        assert(mapped.View()[1000] == 250.0);
+    }
+    std::filesystem::remove(path);
+#endif
+    cout << "Done!"s << endl << endl;
+}
+
+void TestCowVector() {
+    cout << "TestCowVector"s << endl;
+    {
+        CowVector<string> v{ "a"s, "b"s, "c"s };
+        CowVector<string> snapshot(v);
+        // копия разделяет буфер
+        assert(snapshot.IsShared() && v.IsShared());
+        assert(snapshot.cbegin() == std::as_const(v).cbegin());
+        // константный доступ не копирует
+        assert(std::as_const(snapshot)[1] == "b"s && snapshot.IsShared());
+
+        v[0] = "x"s;
+        assert(!v.IsShared() && !snapshot.IsShared());
+        assert((snapshot == CowVector<string>{ "a"s, "b"s, "c"s }));
+        assert((v == CowVector<string>{ "x"s, "b"s, "c"s }));
+
+        CowVector<string> other(v);
+        // итератор в разделяемый буфер пересчитывается после копирования
+        other.Insert(other.cbegin() + 1, "y"s);
+        other.Erase(other.cbegin());
+        assert((other == CowVector<string>{ "y"s, "b"s, "c"s }));
+        assert((v == CowVector<string>{ "x"s, "b"s, "c"s }));
+
+        CowVector<string> cleared(v);
+        cleared.Clear();
+        assert(cleared.IsEmpty() && v.GetSize() == 3 && !v.IsShared());
+        cleared.PushBack("z"s);
+        assert(cleared.GetSize() == 1);
+    }
+    {
+        // Ссылка и итератор, выданные до копирования, не должны менять снимок
+        CowVector<string> v{ "a"s, "b"s };
+        string& first = v[0];
+        CowVector<string> snapshot(v);
+        assert(!snapshot.IsShared() && !v.IsShared());
+        first = "x"s;
+        assert(snapshot[0] == "a"s && std::as_const(v)[0] == "x"s);
+
+        CowVector<string> w{ "c"s, "d"s };
+        auto it = w.begin();
+        const CowVector<string> w_snapshot(w);
+        *(it + 1) = "y"s;
+        assert((w_snapshot == CowVector<string>{ "c"s, "d"s }));
+        assert((w == CowVector<string>{ "c"s, "y"s }));
+
+        // после очистки прежние ссылки недействительны, и буфер снова разделяется
+        w.Clear();
+        w.PushBack("e"s);
+        const CowVector<string> shared(w);
+        assert(shared.IsShared() && w.IsShared());
+    }
+    {
+        // снимки, изменяемые и читаемые из разных потоков, изолированы друг от друга
+        const size_t size = 10000;
+        SimpleVector<int> items(size);
+        iota(items.begin(), items.end(), 0);
+        CowVector<int> origin(std::move(items));
+
+        vector<future<void>> futures;
+        for (int thread = 0; thread < 4; ++thread) {
+            CowVector<int> snapshot(origin);
+            futures.push_back(async(launch::async, [snapshot, thread]() mutable {
+                const CowVector<int> reader(snapshot);
+                for (size_t i = 0; i < size; ++i) {
+                    snapshot[i] += thread + 1;
+                    snapshot.PushBack(thread);
+                }
+                for (size_t i = 0; i < size; ++i) {
+                    assert(snapshot[i] == static_cast<int>(i) + thread + 1);
+                    assert(reader[i] == static_cast<int>(i));
+                }
+            }));
+        }
+        for (size_t i = 0; i < size; ++i) {
+            origin[i] = -1;
+        }
+        for (auto& f : futures) {
+            f.get();
+        }
+        assert(all_of(origin.begin(), origin.end(), [](int x) { return x == -1; }));
+    }
+    cout << "Done!"s << endl << endl;
+}
+
+void TestSegmentedVector() {
+    cout << "TestSegmentedVector"s << endl;
+    {
+        SegmentedVector<int> v;
+        assert(v.IsEmpty() && v.GetCapacity() == 0);
+        v.PushBack(0);
+        const int* first = &v[0];
+        vector<const int*> addresses{ first };
+        for (int i = 1; i < 1000; ++i) {
+            v.PushBack(i);
+            addresses.push_back(&v[i]);
+        }
+        // рост не перемещает элементы
+        assert(&v[0] == first);
+        for (size_t i = 0; i < addresses.size(); ++i) {
+            assert(addresses[i] == &v[i] && v[i] == static_cast<int>(i));
+        }
+        assert(v.GetCapacity() >= 1000 && v.GetCapacity() < 2100);
+
+        try {
+            v.At(1000);
+            assert(false);
+        }
+        catch (const out_of_range&) {
+        }
+
+        // итератор произвольного доступа подходит для стандартных алгоритмов
+        std::reverse(v.begin(), v.end());
+        assert(v[0] == 999 && v[999] == 0);
+        std::sort(v.begin(), v.end());
+        assert(std::is_sorted(v.cbegin(), v.cend()) && v.end() - v.begin() == 1000);
+        [[maybe_unused]] SegmentedVector<int>::ConstIterator it = v.begin() + 500;
+        assert(*it == 500 && it[10] == 510 && *(it - 1) == 499);
+
+        [[maybe_unused]] const size_t capacity = v.GetCapacity();
+        v.Resize(10);
+        assert(v.GetSize() == 10 && v.GetCapacity() == capacity && &v[0] == first);
+        v.Resize(20);
+        assert(v[19] == 0 && v[9] == 9);
+        v.Reserve(5000);
+        assert(v.GetCapacity() >= 5000 && &v[0] == first);
+    }
+    {
+        // PopBack, Resize и деструктор разрушают элементы
+        auto counter = make_shared<int>();
+        {
+            SegmentedVector<shared_ptr<int>> v(100, counter);
+            assert(counter.use_count() == 101);
+            v.PopBack();
+            v.Resize(50);
+            assert(counter.use_count() == 51);
+
+            SegmentedVector<shared_ptr<int>> copy(v);
+            assert(counter.use_count() == 101 && copy == v);
+            [[maybe_unused]] const shared_ptr<int>* address = &v[0];
+            SegmentedVector<shared_ptr<int>> moved(std::move(v));
+            assert(v.IsEmpty() && &moved[0] == address);
+            copy.Clear();
+            assert(counter.use_count() == 51);
+        }
+        assert(counter.use_count() == 1);
+    }
+    {
+        SegmentedVector<int> a{ 1, 2, 3 };
+        SegmentedVector<int> b{ 1, 2, 4 };
+        assert(a != b && a < b && b > a && a <= a && b >= a);
+    }
+    cout << "Done!"s << endl << endl;
+}
+
+void BenchmarkSegmentedVector() {
+    cout << "BenchmarkSegmentedVector"s << endl;
+    const size_t count = 10000000;
+    SimpleVector<int> simple;
+    SegmentedVector<int> segmented;
+    {
+        LOG_DURATION("SimpleVector PushBack of 10M ints"s);
+        for (size_t i = 0; i < count; ++i) {
+            simple.PushBack(static_cast<int>(i));
+        }
+    }
+    {
+        LOG_DURATION("SegmentedVector PushBack of 10M ints"s);
+        for (size_t i = 0; i < count; ++i) {
+            segmented.PushBack(static_cast<int>(i));
+        }
+    }
+    int64_t simple_sum = 0;
+    int64_t segmented_sum = 0;
+    {
+        LOG_DURATION("SimpleVector indexed reads of 10M ints"s);
+        for (size_t i = 0; i < count; ++i) {
+            simple_sum += simple[i];
+        }
+    }
+    {
+        LOG_DURATION("SegmentedVector indexed reads of 10M ints"s);
+        for (size_t i = 0; i < count; ++i) {
+            segmented_sum += segmented[i];
+        }
+    }
+    assert(simple_sum == segmented_sum);
+    {
+        LOG_DURATION("SimpleVector iteration over 10M ints"s);
+        simple_sum = std::accumulate(simple.begin(), simple.end(), int64_t{ 0 });
+    }
+    {
+        LOG_DURATION("SegmentedVector iteration over 10M ints"s);
+        segmented_sum = std::accumulate(segmented.begin(), segmented.end(), int64_t{ 0 });
+    }
+    assert(simple_sum == segmented_sum);
+    cout << "Done!"s << endl << endl;
+}
+
+void TestSoAVector() {
+    cout << "TestSoAVector"s << endl;
+    {
+        SoAVector<int, string, double> v;
+        assert(v.IsEmpty() && v.GetCapacity() == 0);
+        for (int i = 0; i < 100; ++i) {
+            v.PushBack(i, to_string(i), i * 0.5);
+        }
+        assert(v.GetSize() == 100 && v.GetCapacity() >= 100);
+
+        // строка - кортеж ссылок на поля
+        auto [id, name, price] = v[42];
+        assert(id == 42 && name == "42"s && price == 21.0);
+        name = "changed"s;
+        assert(v.Get<1>(42) == "changed"s);
+        v[42] = std::make_tuple(7, "seven"s, 3.5);
+        assert(v.Get<0>(42) == 7 && v.Get<1>(42) == "seven"s && v.Get<2>(42) == 3.5);
+
+        // столбцы непрерывны
+        [[maybe_unused]] Span<const double> prices = std::as_const(v).Column<2>();
+        assert(prices.GetSize() == 100 && &prices[1] == &prices[0] + 1);
+        assert(std::accumulate(prices.begin(), prices.end(), 0.0) == 2475.0 - 21.0 + 3.5);
+
+        [[maybe_unused]] auto it = v.Erase(v.cbegin() + 42);
+        assert(v.GetSize() == 99 && std::get<0>(*it) == 43 && v.Get<1>(98) == "99"s);
+
+        int expected = 0;
+        for ([[maybe_unused]] auto [row_id, row_name, row_price] : v) {
+            if (expected == 42) {
+                ++expected;
+            }
+            assert(row_id == expected && row_name == to_string(expected) && row_price == expected * 0.5);
+            ++expected;
+        }
+
+        SoAVector<int, string, double> copy(v);
+        assert(copy.GetSize() == 99 && copy.Get<1>(0) == "0"s);
+        v.Resize(10);
+        assert(v.GetSize() == 10 && copy.GetSize() == 99);
+        v.Resize(12);
+        assert(v.Get<0>(11) == 0 && v.Get<1>(11).empty());
+        SoAVector<int, string, double> moved(std::move(copy));
+        assert(copy.IsEmpty() && moved.GetSize() == 99);
+        try {
+            moved.At(99);
+            assert(false);
+        }
+        catch (const out_of_range&) {
+        }
+    }
+    {
+        // исключение при переносе одного столбца не изменяет ни один из столбцов
+        SoAVector<NothrowMove, MayThrow> v;
+        v.Reserve(4);
+        for (int i = 0; i < 4; ++i) {
+            v.PushBack(NothrowMove(to_string(i)), MayThrow(i));
+        }
+        MayThrow::copies_until_throw = 2;
+        try {
+            v.Reserve(100);
+            assert(false);
+        }
+        catch (const runtime_error&) {
+        }
+        MayThrow::copies_until_throw = -1;
+        assert(v.GetCapacity() == 4);
+        for (int i = 0; i < 4; ++i) {
+            assert(v.Get<0>(i).value == to_string(i) && v.Get<1>(i).value == i);
+        }
+        v.Reserve(100);
+        assert(v.GetCapacity() == 100 && v.Get<0>(3).value == "3"s && v.Get<1>(3).value == 3);
+    }
+    {
+        // столбец без копирования с небросающим перемещением переносится только после успешного копирования остальных
+        struct MoveOnlyName {
+            explicit MoveOnlyName(string value)
+                : value(std::move(value)) {
+            }
+            MoveOnlyName(const MoveOnlyName&) = delete;
+            MoveOnlyName(MoveOnlyName&&) noexcept = default;
+            MoveOnlyName& operator=(MoveOnlyName&&) noexcept = default;
+
+            string value;
+        };
+        SoAVector<MoveOnlyName, MayThrow> v;
+        v.Reserve(4);
+        for (int i = 0; i < 4; ++i) {
+            v.PushBack(MoveOnlyName(to_string(i)), MayThrow(i));
+        }
+        MayThrow::copies_until_throw = 2;
+        try {
+            v.Reserve(100);
+            assert(false);
+        }
+        catch (const runtime_error&) {
+        }
+        MayThrow::copies_until_throw = -1;
+        assert(v.GetCapacity() == 4);
+        for (int i = 0; i < 4; ++i) {
+            assert(v.Get<0>(i).value == to_string(i) && v.Get<1>(i).value == i);
+        }
+        v.Reserve(100);
+        assert(v.GetCapacity() == 100 && v.Get<0>(3).value == "3"s && v.Get<1>(3).value == 3);
+    }
+    {
+        // вместимость столбцов растёт согласно политике роста, как у SimpleVector
+        BasicSoAVector<OneAndHalfGrowth, int, double> v;
+        for (int i = 0; i < 7; ++i) {
+            v.PushBack(i, i * 0.5);
+        }
+        assert(v.GetSize() == 7 && v.GetCapacity() == 9 && v.Get<1>(6) == 3.0);
+    }
+    cout << "Done!"s << endl << endl;
+}
+
+// Запись, которую в вариантах AoS и SoA просматривают по одному полю
+struct Quote {
+    int64_t id;
+    double price;
+    int32_t qty;
+    int64_t ts;
+};
+
+void BenchmarkSoAVector() {
+    cout << "BenchmarkSoAVector"s << endl;
+    const size_t count = 10000000;
+    SimpleVector<Quote> aos;
+    SoAVector<int64_t, double, int32_t, int64_t> soa;
+    aos.Reserve(count);
+    soa.Reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        const double price = static_cast<double>(i % 1000);
+        aos.PushBack({ static_cast<int64_t>(i), price, 1, static_cast<int64_t>(i) });
+        soa.PushBack(static_cast<int64_t>(i), price, 1, static_cast<int64_t>(i));
+    }
+    double aos_sum = 0;
+    double soa_sum = 0;
+    {
+        LOG_DURATION("AoS SimpleVector price scan of 10M rows"s);
+        for (const Quote& quote : aos) {
+            aos_sum += quote.price;
+        }
+    }
+    {
+        LOG_DURATION("SoAVector price column scan of 10M rows"s);
+        for (double price : soa.Column<1>()) {
+            soa_sum += price;
+        }
+    }
+    assert(aos_sum == soa_sum);
+    cout << "Done!"s << endl << endl;
+}
+
+// Собирает InplaceVector в константном выражении
+constexpr InplaceVector<int, 8> MakeInplaceVector() {
+    InplaceVector<int, 8> v{ 1, 2, 3 };
+    v.PushBack(5);
+    v.Insert(v.begin() + 3, 4);
+    v.Erase(v.begin());
+    v.Resize(6);
+    v.TryPushBack(7);
+    return v;
+}
+
+void TestInplaceVector() {
+    cout << "TestInplaceVector"s << endl;
+    {
+        constexpr InplaceVector<int, 8> v = MakeInplaceVector();
+        static_assert(v.GetSize() == 7 && v[0] == 2 && v[3] == 5 && v[4] == 0 && v[6] == 7);
+        static_assert(InplaceVector<int, 8>::GetCapacity() == 8);
+#ifdef __cpp_lib_is_constant_evaluated
+        static_assert(v == InplaceVector<int, 8>{ 2, 3, 4, 5, 0, 0, 7 });
+        static_assert(v < InplaceVector<int, 8>{ 2, 3, 5 });
+#endif
+        assert((v == InplaceVector<int, 8>{ 2, 3, 4, 5, 0, 0, 7 }));
+        assert((v < InplaceVector<int, 8>{ 2, 3, 5 }));
+        static_assert(sizeof(InplaceVector<int, 8>) == sizeof(int) * 8 + sizeof(size_t));
+    }
+    {
+        InplaceVector<int, 4> v;
+        for (int i = 0; i < 4; ++i) {
+            assert(v.TryPushBack(i));
+        }
+        // переполнение без исключения
+        assert(v.IsFull() && !v.TryPushBack(4) && v.TryEmplaceBack(4) == nullptr);
+        assert(v.GetSize() == 4 && v[3] == 3);
+        try {
+            v.PushBack(4);
+            assert(false);
+        }
+        catch (const length_error&) {
+        }
+        try {
+            v.Insert(v.begin(), 4);
+            assert(false);
+        }
+        catch (const length_error&) {
+        }
+        try {
+            v.Resize(5);
+            assert(false);
+        }
+        catch (const length_error&) {
+        }
+        assert((v == InplaceVector<int, 4>{ 0, 1, 2, 3 }));
+    }
+    {
+        // нетривиальные элементы создаются во внутреннем буфере и разрушаются вектором
+        auto counter = make_shared<int>();
+        {
+            InplaceVector<shared_ptr<int>, 8> v(3, counter);
+            assert(counter.use_count() == 4);
+            [[maybe_unused]] const shared_ptr<int>* data = v.begin();
+            assert(reinterpret_cast<const unsigned char*>(data) >= reinterpret_cast<const unsigned char*>(&v)
+                && reinterpret_cast<const unsigned char*>(data) < reinterpret_cast<const unsigned char*>(&v) + sizeof(v));
+
+            v.Insert(v.begin() + 1, nullptr);
+            assert(v.GetSize() == 4 && v[1] == nullptr && v[3] == counter);
+            v.Erase(v.begin());
+            assert(v.GetSize() == 3 && v[0] == nullptr && counter.use_count() == 3);
+
+            InplaceVector<shared_ptr<int>, 8> copy(v);
+            assert(counter.use_count() == 5);
+            InplaceVector<shared_ptr<int>, 8> other{ counter };
+            other.swap(copy);
+            assert(other.GetSize() == 3 && copy.GetSize() == 1 && counter.use_count() == 6);
+            copy = other;
+            assert(copy.GetSize() == 3 && copy == other && counter.use_count() == 7);
+            other.Clear();
+            assert(counter.use_count() == 5);
+            v.Resize(1);
+            assert(counter.use_count() == 3);
+        }
+        assert(counter.use_count() == 1);
+    }
+    {
+        InplaceVector<string, 4> v{ "a"s, "c"s };
+        v.Emplace(v.begin() + 1, 1, 'b');
+        v.EmplaceBack("d"s);
+        assert((v == InplaceVector<string, 4>{ "a"s, "b"s, "c"s, "d"s }));
+        InplaceVector<string, 4> moved(std::move(v));
+        assert(moved.GetSize() == 4 && moved[3] == "d"s);
+        try {
+            moved.At(4);
+            assert(false);
+        }
+        catch (const out_of_range&) {
+        }
+    }
+    cout << "Done!"s << endl << endl;
+}
+
+#ifdef __cpp_lib_constexpr_dynamic_alloc
+// Таблица квадратов, вычисляемая с помощью SimpleVector на этапе компиляции.
+// Память, выделенная в константном выражении, должна освобождаться в нём же,
+// поэтому результат копируется в std::array, который попадает в двоичный файл
+template <size_t N>
+constexpr std::array<int, N> MakeSquaresTable() {
+    SimpleVector<int> squares;
+    for (int i = 0; i < static_cast<int>(N); ++i) {
+        squares.PushBack(i * i);
+    }
+    std::array<int, N> table{};
+    std::copy(squares.begin(), squares.end(), table.begin());
+    return table;
+}
+
+// Тривиально копируемые элементы: пути memmove и memcpy заменяются поэлементным переносом
+constexpr bool CheckConstexprTrivialItems() {
+    SimpleVector<int> v;
+    for (int i = 0; i < 8; ++i) {
+        v.PushBack(i);
+    }
+    v.Insert(v.begin() + 2, 100);  // перевыделение с промежутком
+    v.Insert(v.begin(), -1);       // сдвиг "хвоста" без перевыделения
+    v.Erase(v.begin() + 3);
+    const int expected[] = { -1, 0, 1, 2, 3, 4, 5, 6, 7 };
+    if (!std::equal(v.begin(), v.end(), std::begin(expected), std::end(expected))) {
+        return false;
+    }
+    v.Resize(20);
+    if (v.GetSize() != 20 || v[19] != 0) {
+        return false;
+    }
+    v.Resize(3);
+    v.InsertRange(v.cbegin() + 1, std::begin(expected), std::begin(expected) + 2);
+    v.ShrinkToFit();
+    SimpleVector<int> copy(v);
+    return copy == SimpleVector<int>{ -1, -1, 0, 0, 1 } && v.GetCapacity() == 5 && v < SimpleVector<int>{ 0 };
+}
+
+// Нетривиальные элементы переносятся и сдвигаются поэлементно через std::construct_at
+constexpr bool CheckConstexprNestedItems() {
+    SimpleVector<SimpleVector<int>> v;
+    for (int i = 0; i < 5; ++i) {
+        v.PushBack(SimpleVector<int>(static_cast<size_t>(i), i));
+    }
+    v.Insert(v.begin() + 1, SimpleVector<int>{ 7, 7 });
+    v.Erase(v.begin());
+    v.Resize(7);
+    return v.GetSize() == 7 && v[0] == SimpleVector<int>{ 7, 7 } && v[1] == SimpleVector<int>{ 1 }
+        && v[4].GetSize() == 4 && v[6].IsEmpty();
+}
+
+void TestConstexprSimpleVector() {
+    cout << "TestConstexprSimpleVector"s << endl;
+    static_assert(CheckConstexprTrivialItems());
+    static_assert(CheckConstexprNestedItems());
+
+    constexpr std::array<int, 16> squares = MakeSquaresTable<16>();
+    static_assert(squares[0] == 0 && squares[15] == 225);
+    // те же функции работают и во время выполнения
+    assert(CheckConstexprTrivialItems() && CheckConstexprNestedItems());
+    assert(MakeSquaresTable<16>() == squares);
+    cout << "Done!"s << endl << endl;
+}
+#endif
+
+// Распределитель, который выбрасывает std::bad_alloc, когда общий счётчик оставшихся выделений доходит до нуля.
+// Отрицательный счётчик отключает сбои
+template <typename Type>
+struct FailingAllocator {
+    using value_type = Type;
+
+    explicit FailingAllocator(int* allocations_until_failure) noexcept
+        : allocations_until_failure(allocations_until_failure) {
+    }
+
+    template <typename Other>
+    FailingAllocator(const FailingAllocator<Other>& other) noexcept
+        : allocations_until_failure(other.allocations_until_failure) {
+    }
+
+    Type* allocate(size_t n) {
+        if (*allocations_until_failure >= 0 && (*allocations_until_failure)-- == 0) {
+            throw std::bad_alloc();
+        }
+        return std::allocator<Type>().allocate(n);
+    }
+
+    void deallocate(Type* p, size_t n) noexcept {
+        std::allocator<Type>().deallocate(p, n);
+    }
+
+    template <typename Other>
+    bool operator==(const FailingAllocator<Other>& other) const noexcept {
+        return allocations_until_failure == other.allocations_until_failure;
+    }
+
+    template <typename Other>
+    bool operator!=(const FailingAllocator<Other>& other) const noexcept {
+        return !(*this == other);
+    }
+
+    int* allocations_until_failure;
+};
+
+void TestConcurrentVector() {
+    cout << "TestConcurrentVector"s << endl;
+    {
+        ConcurrentVector<string> v;
+        assert(v.IsEmpty() && v.GetCapacity() == 0);
+        assert(v.PushBack("a"s) == 0 && v.EmplaceBack(3, 'b') == 1);
+        assert(v.GetSize() == 2 && v[1] == "bbb"s && v.At(0) == "a"s);
+        try {
+            v.At(2);
+            assert(false);
+        }
+        catch (const out_of_range&) {
+        }
+        v.Reserve(1000);
+        assert(v.GetCapacity() >= 1000);
+    }
+    {
+        // Сбой выделения блока не оставляет в префиксе незаполненной ячейки:
+        // следующие элементы публикуются и получают индексы подряд
+        int allocations_until_failure = 1;
+        ConcurrentVector<string, FailingAllocator<string>> v{ FailingAllocator<string>(&allocations_until_failure) };
+        for (int i = 0; i < 32; ++i) {
+            assert(v.PushBack(to_string(i)) == static_cast<size_t>(i));
+        }
+        // второй блок выделить не удаётся
+        try {
+            v.PushBack("lost"s);
+            assert(false);
+        }
+        catch (const bad_alloc&) {
+        }
+        assert(v.GetSize() == 32 && v.GetCapacity() == 32);
+        for (int i = 32; i < 39; ++i) {
+            assert(v.PushBack(to_string(i)) == static_cast<size_t>(i));
+        }
+        assert(v.GetSize() == 39);
+        for (size_t i = 0; i < v.GetSize(); ++i) {
+            assert(v.At(i) == to_string(i));
+        }
+    }
+    {
+        // Индекс, зарезервированный до неудачного выделения блока, не останавливает публикацию:
+        // повторный сбой оставляет его брошенным, а первое успешное добавление заполняет его
+        int allocations_until_failure = 0;
+        ConcurrentVector<string, FailingAllocator<string>> v{ FailingAllocator<string>(&allocations_until_failure) };
+        try {
+            v.PushBack("lost"s);
+            assert(false);
+        }
+        catch (const bad_alloc&) {
+        }
+        allocations_until_failure = 0;
+        try {
+            v.PushBack("lost again"s);
+            assert(false);
+        }
+        catch (const bad_alloc&) {
+        }
+        assert(v.GetSize() == 0 && v.GetCapacity() == 0);
+        assert(v.PushBack("0"s) == 0 && v.PushBack("1"s) == 1);
+        assert(v.GetSize() == 2 && v.At(0) == "0"s && v.At(1) == "1"s);
+    }
+    {
+        // производители добавляют элементы, читатель одновременно проверяет опубликованный префикс
+        const int producer_count = 4;
+        const int per_producer = 20000;
+        ConcurrentVector<string> v;
+        v.PushBack("0:0"s);
+        [[maybe_unused]] const string* first = &v[0];
+
+        std::atomic<bool> done = false;
+        auto reader = async(launch::async, [&v, &done] {
+            size_t checked = 0;
+            while (!done.load()) {
+                const size_t size = v.GetSize();
+                assert(size >= checked);
+                // каждый элемент префикса полностью создан
+                for (; checked < size; ++checked) {
+                    [[maybe_unused]] const string& item = v[checked];
+                    assert(item.find(':') != string::npos);
+                }
+            }
+            return checked;
+        });
+
+        vector<future<void>> producers;
+        for (int producer = 0; producer < producer_count; ++producer) {
+            producers.push_back(async(launch::async, [&v, producer] {
+                for (int i = 1; i <= per_producer; ++i) {
+                    v.PushBack(to_string(producer) + ":"s + to_string(i));
+                }
+            }));
+        }
+        for (auto& producer : producers) {
+            producer.get();
+        }
+        done = true;
+        assert(reader.get() <= v.GetSize());
+
+        assert(v.GetSize() == producer_count * per_producer + 1);
+        assert(&v[0] == first);
+        // элементы каждого производителя следуют в порядке добавления и не теряются
+        vector<int> last(producer_count, 0);
+        for (auto it = v.begin() + 1; it != v.end(); ++it) {
+            const size_t colon = it->find(':');
+            const int producer = stoi(it->substr(0, colon));
+            const int seq = stoi(it->substr(colon + 1));
+            assert(seq == last[producer] + 1);
+            last[producer] = seq;
+        }
+        assert(all_of(last.begin(), last.end(), [](int seq) { return seq == per_producer; }));
+    }
+    {
+        // исключение конструктора не занимает индекс
+        ConcurrentVector<string> v;
+        v.PushBack("a"s);
+        try {
+            v.EmplaceBack(std::numeric_limits<size_t>::max(), 'x');
+            assert(false);
+        }
+        catch (const length_error&) {
+        }
+        v.PushBack("b"s);
+        assert(v.GetSize() == 2 && v[1] == "b"s);
+    }
+    cout << "Done!"s << endl << endl;
+}
+
+void BenchmarkConcurrentVector() {
+    cout << "BenchmarkConcurrentVector"s << endl;
+    const size_t count = 4000000;
+    const size_t max_producers = std::max<size_t>(4, std::thread::hardware_concurrency());
+    for (size_t producers = 1; producers <= max_producers; producers *= 2) {
+        const size_t per_producer = count / producers;
+        {
+            SimpleVector<int> items;
+            std::mutex mutex;
+            LOG_DURATION("SimpleVector + mutex, "s + to_string(producers) + " producers"s);
+            vector<future<void>> futures;
+            for (size_t producer = 0; producer < producers; ++producer) {
+                futures.push_back(async(launch::async, [&items, &mutex, per_producer] {
+                    for (size_t i = 0; i < per_producer; ++i) {
+                        std::lock_guard guard(mutex);
+                        items.PushBack(static_cast<int>(i));
+                    }
+                }));
+            }
+            for (auto& f : futures) {
+                f.get();
+            }
+            assert(items.GetSize() == per_producer * producers);
+        }
+        {
+            ConcurrentVector<int> items;
+            LOG_DURATION("ConcurrentVector, "s + to_string(producers) + " producers"s);
+            vector<future<void>> futures;
+            for (size_t producer = 0; producer < producers; ++producer) {
+                futures.push_back(async(launch::async, [&items, per_producer] {
+                    for (size_t i = 0; i < per_producer; ++i) {
+                        items.PushBack(static_cast<int>(i));
+                    }
+                }));
+            }
+            for (auto& f : futures) {
+                f.get();
+            }
+            assert(items.GetSize() == per_producer * producers);
+        }
+    }
+    cout << "Done!"s << endl << endl;
+}
+
+void TestAppendUninitialized() {
+    cout << "TestAppendUninitialized"s << endl;
+    {
+        SimpleVector<int> v{ 1, 2 };
+        Span<int> batch = v.AppendUninitialized(5);
+        assert(batch.GetSize() == 5 && v.GetSize() == 2 && v.GetCapacity() >= 7);
+        assert(batch.Data() == v.Data() + v.GetSize());
+        for (size_t i = 0; i < batch.GetSize(); ++i) {
+            batch[i] = static_cast<int>(i) + 3;
+        }
+        // можно добавить только часть заполненных ячеек
+        v.CommitAppend(3);
+        assert((v == SimpleVector<int>{ 1, 2, 3, 4, 5 }));
+
+        v.CommitAppend(0);
+        v.AppendUninitialized(0);
+        assert(v.GetSize() == 5);
+    }
+    {
+        // повторные пакеты растут геометрически, а не на размер пакета
+        size_t allocations = 0;
+        SimpleVector<int, CountingAllocator<int>> v{ CountingAllocator<int>(&allocations) };
+        for (int batch_index = 0; batch_index < 1000; ++batch_index) {
+            Span<int> batch = v.AppendUninitialized(10);
+            std::iota(batch.begin(), batch.end(), batch_index * 10);
+            v.CommitAppend(batch.GetSize());
+        }
+        assert(v.GetSize() == 10000 && allocations < 20);
+        for (size_t i = 0; i < v.GetSize(); ++i) {
+            assert(v[i] == static_cast<int>(i));
+        }
+    }
+    {
+        // ячейки тривиальных структур заполняются присваиванием
+        struct Sample {
+            int channel;
+            double value;
+        };
+        SimpleVector<Sample> v(Reserve(1));
+        Span<Sample> batch = v.AppendUninitialized(3);
+        for (size_t i = 0; i < batch.GetSize(); ++i) {
+            batch[i] = { static_cast<int>(i), i * 0.5 };
+        }
+        v.CommitAppend(3);
+        assert(v.GetSize() == 3 && v[2].channel == 2 && v[2].value == 1.0);
+    }
+    cout << "Done!"s << endl << endl;
+}
+
+void BenchmarkAppendUninitialized() {
+    cout << "BenchmarkAppendUninitialized"s << endl;
+    // "Декодер" восстанавливает значения из разностей соседних элементов
+    const size_t count = 20000000;
+    SimpleVector<int> deltas(count, 1);
+    {
+        LOG_DURATION("PushBack decode of 20M ints"s);
+        SimpleVector<int> decoded;
+        decoded.Reserve(count);
+        int value = 0;
+        for (int delta : deltas) {
+            value += delta;
+            decoded.PushBack(value);
+        }
+        assert(decoded[count - 1] == static_cast<int>(count));
+    }
+    {
+        LOG_DURATION("AppendUninitialized decode of 20M ints"s);
+        SimpleVector<int> decoded;
+        Span<int> batch = decoded.AppendUninitialized(count);
+        int value = 0;
+        int* out = batch.Data();
+        for (int delta : deltas) {
+            value += delta;
+            *out++ = value;
+        }
+        decoded.CommitAppend(count);
+        assert(decoded[count - 1] == static_cast<int>(count));
+    }
+    cout << "Done!"s << endl << endl;
+}
+
+template <typename Type>
+using CheckedSimpleVector = SimpleVector<Type, std::allocator<Type>, DoublingGrowth, true>;
+
+// Проверяет, что вызов func выбрасывает исключение ровно типа Exception, а не производного от него
+template <typename Exception, typename Func>
+bool Throws(Func func) {
+    try {
+        func();
+    }
+    catch (const std::exception& e) {
+        return typeid(e) == typeid(Exception);
+    }
+    return false;
+}
+
+void TestCheckedIterators() {
+    cout << "TestCheckedIterators"s << endl;
+    // В обычном режиме итераторы - указатели, а вектор не хранит ничего лишнего
+    static_assert(std::is_same_v<SimpleVector<int, std::allocator<int>, DoublingGrowth, false>::Iterator, int*>);
+    static_assert(std::is_same_v<SimpleVector<int, std::allocator<int>, DoublingGrowth, false>::ConstIterator, const int*>);
+    static_assert(sizeof(SimpleVector<int, std::allocator<int>, DoublingGrowth, false>) == sizeof(ArrayPtr<int, true>) + sizeof(size_t));
+    {
+        // Итераторы проверяемого вектора работают со стандартными алгоритмами
+        CheckedSimpleVector<int> v{ 3, 1, 2 };
+        std::sort(v.begin(), v.end());
+        assert(std::is_sorted(v.cbegin(), v.cend()));
+        assert(std::accumulate(v.begin(), v.end(), 0) == 6);
+        assert(v.end() - v.begin() == 3 && v.begin()[2] == 3);
+        [[maybe_unused]] CheckedSimpleVector<int>::ConstIterator it = v.begin();
+        assert(it == v.cbegin() && *++it == 2);
+    }
+    {
+        // Добавление без перевыделения не делает итераторы недействительными
+        CheckedSimpleVector<int> v(Reserve(4));
+        v.PushBack(1);
+        [[maybe_unused]] auto it = v.begin();
+        v.PushBack(2);
+        assert(*it == 1);
+        // А перевыделение памяти - делает
+        v.PushBack(3);
+        v.PushBack(4);
+        v.PushBack(5);
+        assert(Throws<logic_error>([&] { return *it; }));
+        assert(Throws<logic_error>([&] { v.Erase(it); }));
+        assert(v.GetSize() == 5);
+    }
+    {
+        // Вставка и удаление сдвигают элементы, поэтому старые итераторы становятся недействительными
+        CheckedSimpleVector<int> v{ 1, 2, 3, 4 };
+        v.Reserve(10);
+        [[maybe_unused]] auto last = v.end() - 1;
+        [[maybe_unused]] auto inserted = v.Insert(v.begin(), 0);
+        assert(*inserted == 0);
+        assert(Throws<logic_error>([&] { return *last; }));
+
+        [[maybe_unused]] auto next = v.Erase(v.begin() + 1);
+        assert(*next == 2);
+        assert(Throws<logic_error>([&] { return *inserted; }));
+
+        auto first = v.begin();
+        v.Clear();
+        assert(Throws<logic_error>([&] { return *first; }));
+
+        v.PushBack(7);
+        first = v.begin();
+        v.PopBack();
+        assert(Throws<logic_error>([&] { return *first; }));
+    }
+    {
+        // Разыменование за границами диапазона [begin(), end())
+        CheckedSimpleVector<int> v{ 1, 2 };
+        assert(Throws<out_of_range>([&] { return *v.end(); }));
+        assert(Throws<out_of_range>([&] { return v.begin()[2]; }));
+        assert(Throws<out_of_range>([&] { return *(v.begin() - 1); }));
+        assert(Throws<logic_error>([] { return *CheckedSimpleVector<int>::Iterator(); }));
+    }
+    {
+        // Обмен и перемещение делают недействительными итераторы обоих векторов,
+        // итератор другого вектора не принимается
+        CheckedSimpleVector<string> a{ "a"s };
+        CheckedSimpleVector<string> b{ "b"s };
+        auto a_it = a.begin();
+        [[maybe_unused]] auto b_it = b.begin();
+        assert(Throws<logic_error>([&] { a.Erase(b_it); }));
+        a.swap(b);
+        assert(Throws<logic_error>([&] { return a_it->size(); }));
+        assert(Throws<logic_error>([&] { return b_it->size(); }));
+
+        a_it = a.begin();
+        CheckedSimpleVector<string> c(std::move(a));
+        assert(Throws<logic_error>([&] { return *a_it; }));
+        assert(c[0] == "b"s && a.IsEmpty());
+    }
+    cout << "Done!"s << endl << endl;
+}
+
+void TestFlatMap() {
+    cout << "TestFlatMap"s << endl;
+    // пустой компаратор хранится как базовый класс и не занимает памяти
+    static_assert(sizeof(FlatMap<int, string>) == sizeof(SimpleVector<int>) + sizeof(SimpleVector<string>));
+    {
+        // Построение из неупорядоченных пар: сортировка один раз, из повторов остаётся первая пара
+        FlatMap<int, string> m{ { 5, "five"s }, { 1, "one"s }, { 3, "three"s }, { 1, "uno"s } };
+        assert(m.GetSize() == 3);
+        assert((std::vector<int>(m.Keys().begin(), m.Keys().end()) == std::vector<int>{ 1, 3, 5 }));
+        assert(m.At(1) == "one"s && m.At(5) == "five"s);
+        assert(m.Contains(3) && !m.Contains(4));
+        assert(m.Find(4) == m.end());
+        auto it = m.Find(3);
+        assert(it != m.end() && it.GetKey() == 3 && it.GetValue() == "three"s);
+        it.GetValue() = "drei"s;
+        assert(m.At(3) == "drei"s);
+
+        try {
+            m.At(2);
+            assert(false);
+        }
+        catch (const out_of_range&) {
+        }
+        catch (...) {
+            assert(false);
+        }
+
+        // Обход в порядке возрастания ключей
+        string joined;
+        for (const auto [key, value] : m) {
+            joined += to_string(key) + value;
+        }
+        assert(joined == "1one3drei5five"s);
+    }
+    {
+        // Одиночные вставка и удаление сохраняют порядок ключей
+        FlatMap<int, int> m;
+        for (int key : { 4, 2, 8, 6, 0 }) {
+            [[maybe_unused]] auto [pos, inserted] = m.Insert(key, key * 10);
+            assert(inserted && pos.GetKey() == key && pos.GetValue() == key * 10);
+        }
+        [[maybe_unused]] auto [pos, inserted] = m.Insert(4, 0);
+        assert(!inserted && pos.GetValue() == 40);
+        assert((std::vector<int>(m.Keys().begin(), m.Keys().end()) == std::vector<int>{ 0, 2, 4, 6, 8 }));
+        assert(std::is_sorted(m.Keys().begin(), m.Keys().end()));
+
+        ++m[2];
+        m[5] = 50;
+        assert(m.At(2) == 21 && m.At(5) == 50 && m.GetSize() == 6);
+
+        assert(m.Erase(0) && m.Erase(8) && !m.Erase(7));
+        assert((std::vector<int>(m.Values().begin(), m.Values().end()) == std::vector<int>{ 21, 40, 50, 60 }));
+    }
+    {
+        // Вставка диапазона сливает отсортированный буфер с массивом, существующие ключи не перезаписываются
+        FlatMap<int, int> m{ { 10, 1 }, { 30, 3 }, { 50, 5 } };
+        std::vector<std::pair<int, int>> added{ { 60, 6 }, { 30, 0 }, { 20, 2 }, { 0, 0 }, { 20, 0 }, { 40, 4 } };
+        m.InsertRange(added.begin(), added.end());
+        const FlatMap<int, int> expected{ { 0, 0 }, { 10, 1 }, { 20, 2 }, { 30, 3 }, { 40, 4 }, { 50, 5 }, { 60, 6 } };
+        assert(m == expected);
+        for (int key = 0; key <= 60; key += 10) {
+            assert(m.Contains(key) && !m.Contains(key + 1));
+        }
+
+    }
+    {
+        // Строковые ключи и пользовательский порядок
+        FlatMap<string, int, std::greater<string>> m{ { "b"s, 2 }, { "a"s, 1 }, { "c"s, 3 } };
+        assert(*m.Keys().begin() == "c"s && m.At("a"s) == 1);
+        FlatMap<string, int, std::greater<string>> other;
+        m.swap(other);
+        assert(m.IsEmpty() && other.GetSize() == 3);
+        other.Clear();
+        assert(other.IsEmpty() && other.begin() == other.end());
+    }
+    {
+        // Исключение при копировании значения во время слияния не меняет массив,
+        // хотя строковые ключи перемещаются без исключений
+        FlatMap<string, MayThrow> m;
+        for (const string& key : { "a"s, "c"s, "e"s }) {
+            m.Insert(key, MayThrow(static_cast<int>(key[0])));
+        }
+        const std::vector<std::pair<string, MayThrow>> added{ { "b"s, MayThrow('b') }, { "d"s, MayThrow('d') } };
+        // две копии уходят на буфер добавляемых пар, третья копирует прежний элемент "a", четвёртая бросает
+        MayThrow::copies_until_throw = 3;
+        try {
+            m.InsertRange(added.begin(), added.end());
+            assert(false);
+        }
+        catch (const runtime_error&) {
+        }
+        MayThrow::copies_until_throw = -1;
+        assert((std::vector<string>(m.Keys().begin(), m.Keys().end()) == std::vector<string>{ "a"s, "c"s, "e"s }));
+        for ([[maybe_unused]] const auto [key, value] : m) {
+            assert(value.value == key[0]);
+        }
+        m.InsertRange(added.begin(), added.end());
+        assert((std::vector<string>(m.Keys().begin(), m.Keys().end()) == std::vector<string>{ "a"s, "b"s, "c"s, "d"s, "e"s }));
+    }
+    {
+        // Исключение компаратора во время слияния тоже не меняет массив
+        int compares_until_throw = -1;
+        auto less = [&compares_until_throw](const string& lhs, const string& rhs) {
+            if (compares_until_throw >= 0 && compares_until_throw-- == 0) {
+                throw runtime_error("compare failed"s);
+            }
+            return lhs < rhs;
+        };
+        FlatMap<string, string, decltype(less)> m(less);
+        m.Insert("a"s, "A"s);
+        m.Insert("c"s, "C"s);
+        m.Insert("e"s, "E"s);
+        const std::vector<std::pair<string, string>> added{ { "d"s, "D"s }, { "b"s, "B"s } };
+        // одно сравнение уходит на сортировку буфера, остальные - на слияние
+        compares_until_throw = 3;
+        try {
+            m.InsertRange(added.begin(), added.end());
+            assert(false);
+        }
+        catch (const runtime_error&) {
+        }
+        compares_until_throw = -1;
+        assert((std::vector<string>(m.Keys().begin(), m.Keys().end()) == std::vector<string>{ "a"s, "c"s, "e"s }));
+        assert((std::vector<string>(m.Values().begin(), m.Values().end()) == std::vector<string>{ "A"s, "C"s, "E"s }));
+    }
+    {
+        // Значения с бросающим присваиванием перемещением не сдвигаются при удалении,
+        // поэтому ключи и значения остаются согласованными
+        FlatMap<int, ThrowingMoveAssign> m;
+        for (int i = 0; i < 5; ++i) {
+            m.Insert(i, ThrowingMoveAssign(i * 10));
+        }
+        ThrowingMoveAssign::assigns_until_throw = 0;
+        assert(m.Erase(1));
+        ThrowingMoveAssign::assigns_until_throw = -1;
+        assert(m.GetSize() == 4 && !m.Contains(1));
+        for ([[maybe_unused]] const int key : { 0, 2, 3, 4 }) {
+            assert(m.At(key).value == key * 10);
+        }
+    }
+    {
+        // При вставке такие значения тоже не сдвигаются: ключи и значения остаются согласованными
+        FlatMap<int, ThrowingMoveAssign> m;
+        for (int i = 0; i < 5; ++i) {
+            m.Insert(i * 2, ThrowingMoveAssign(i * 20));
+        }
+        ThrowingMoveAssign::assigns_until_throw = 0;
+        assert(m.Insert(3, ThrowingMoveAssign(30)).second);
+        m[5].value = 50;
+        ThrowingMoveAssign::assigns_until_throw = -1;
+        assert(m.GetSize() == 7 && m.Keys().GetSize() == m.Values().GetSize());
+        for (size_t i = 0; i < m.GetSize(); ++i) {
+            assert(m.Values()[i].value == m.Keys()[i] * 10);
+        }
+    }
+    assert(ThrowingMoveAssign::alive == 0);
+    cout << "Done!"s << endl << endl;
+}
+
+void TestFlatSet() {
+    cout << "TestFlatSet"s << endl;
+    static_assert(sizeof(FlatSet<int>) == sizeof(SimpleVector<int>));
+    {
+        FlatSet<int> s{ 5, 3, 9, 3, 1 };
+        assert((std::vector<int>(s.begin(), s.end()) == std::vector<int>{ 1, 3, 5, 9 }));
+        assert(s.Contains(9) && !s.Contains(4));
+        assert(s.Find(5) == s.begin() + 2 && s.Find(0) == s.end());
+
+        [[maybe_unused]] auto [pos, inserted] = s.Insert(4);
+        assert(inserted && *pos == 4 && pos == s.begin() + 2);
+        assert(!s.Insert(9).second);
+
+        const std::vector<int> added{ 8, 0, 4, 8, 10 };
+        s.InsertRange(added.begin(), added.end());
+        assert((s == FlatSet<int>{ 0, 1, 3, 4, 5, 8, 9, 10 }));
+
+        assert(s.Erase(0) && !s.Erase(0) && s.Erase(10));
+        assert((s == FlatSet<int>{ 1, 3, 4, 5, 8, 9 }));
+    }
+    {
+        // Проверка по всем значениям: множество совпадает с std::set при любых вставках
+        std::mt19937 generator(42);
+        FlatSet<int> flat;
+        std::set<int> reference;
+        for (int round = 0; round < 50; ++round) {
+            std::vector<int> batch(round % 7 * 10);
+            for (int& value : batch) {
+                value = static_cast<int>(generator() % 500);
+            }
+            flat.InsertRange(batch.begin(), batch.end());
+            reference.insert(batch.begin(), batch.end());
+            [[maybe_unused]] const int single = static_cast<int>(generator() % 500);
+            assert(flat.Insert(single).second == reference.insert(single).second);
+            [[maybe_unused]] const int erased = static_cast<int>(generator() % 500);
+            assert(flat.Erase(erased) == (reference.erase(erased) == 1));
+            assert(std::equal(flat.begin(), flat.end(), reference.begin(), reference.end()));
+        }
+    }
+    {
+        // Однопроходный диапазон сначала собирается в буфер
+        std::istringstream input("7 -1 7 3"s);
+        FlatSet<int> s{ std::istream_iterator<int>(input), std::istream_iterator<int>() };
+        assert((s == FlatSet<int>{ -1, 3, 7 }));
+    }
+    {
+        FlatSet<string> s{ "pear"s, "apple"s, "plum"s };
+        assert(*s.begin() == "apple"s && s.Contains("plum"s));
+        s.Clear();
+        assert(s.IsEmpty());
+    }
+    {
+        // Исключение компаратора во время слияния не меняет множество
+        int compares_until_throw = -1;
+        auto less = [&compares_until_throw](const string& lhs, const string& rhs) {
+            if (compares_until_throw >= 0 && compares_until_throw-- == 0) {
+                throw runtime_error("compare failed"s);
+            }
+            return lhs < rhs;
+        };
+        FlatSet<string, decltype(less)> s({ "a"s, "c"s, "e"s }, less);
+        const std::vector<string> added{ "d"s, "b"s };
+        compares_until_throw = 3;
+        try {
+            s.InsertRange(added.begin(), added.end());
+            assert(false);
+        }
+        catch (const runtime_error&) {
+        }
+        compares_until_throw = -1;
+        assert((std::vector<string>(s.begin(), s.end()) == std::vector<string>{ "a"s, "c"s, "e"s }));
+    }
+    cout << "Done!"s << endl << endl;
+}
+
+void BenchmarkFlatMap() {
+    cout << "BenchmarkFlatMap"s << endl;
+    std::mt19937 generator(1);
+    for (size_t size : { 64, 1024, 65536 }) {
+        std::vector<std::pair<int, int>> items;
+        for (size_t i = 0; i < size; ++i) {
+            items.emplace_back(static_cast<int>(generator() % (size * 4)), static_cast<int>(i));
+        }
+        std::vector<int> lookups(1 << 20);
+        for (int& key : lookups) {
+            key = static_cast<int>(generator() % (size * 4));
+        }
+
+        std::map<int, int> tree(items.begin(), items.end());
+        std::map<int, int> tree_built;
+        FlatMap<int, int> flat_built;
+        {
+            LOG_DURATION("std::map build of "s + to_string(size) + " items"s);
+            tree_built.insert(items.begin(), items.end());
+        }
+        {
+            LOG_DURATION("FlatMap build of "s + to_string(size) + " items"s);
+            flat_built.InsertRange(items.begin(), items.end());
+        }
+        assert(flat_built.GetSize() == tree_built.size());
+
+        int64_t tree_sum = 0;
+        int64_t flat_sum = 0;
+        {
+            LOG_DURATION("std::map 1M lookups in "s + to_string(size) + " items"s);
+            for (int key : lookups) {
+                const auto it = tree.find(key);
+                tree_sum += it != tree.end() ? it->second : -1;
+            }
+        }
+        {
+            LOG_DURATION("FlatMap 1M lookups in "s + to_string(size) + " items"s);
+            for (int key : lookups) {
+                const auto it = std::as_const(flat_built).Find(key);
+                flat_sum += it != flat_built.cend() ? it.GetValue() : -1;
+            }
+        }
+        assert(tree_sum == flat_sum);
+    }
+    cout << "Done!"s << endl << endl;
+}
+
+// Хеш-функция, отправляющая все ключи в одну цепочку поиска
+struct ConstantHash {
+    size_t operator()(int) const noexcept {
+        return 0;
+    }
+};
+
+void TestFlatHashMap() {
+    cout << "TestFlatHashMap"s << endl;
+    // пустые хеш-функция и предикат равенства хранятся как базовые классы и не занимают памяти
+    static_assert(sizeof(FlatHashMap<int, string>) == sizeof(ArrayPtr<int8_t>) + sizeof(ArrayPtr<std::pair<int, string>, true>) + 2 * sizeof(size_t));
+    {
+        FlatHashMap<int, string> m{ { 1, "one"s }, { 2, "two"s }, { 3, "three"s }, { 1, "uno"s } };
+        assert(m.GetSize() == 3 && m.GetCapacity() == 16);
+        assert(m.At(1) == "one"s && m.At(3) == "three"s);
+        assert(m.Contains(2) && !m.Contains(4) && m.Find(4) == m.end());
+        auto it = m.Find(2);
+        assert(it != m.end() && it.GetKey() == 2 && it.GetValue() == "two"s);
+        it.GetValue() = "zwei"s;
+        assert(m.At(2) == "zwei"s);
+
+        [[maybe_unused]] auto [pos, inserted] = m.Insert(4, "four"s);
+        assert(inserted && pos.GetKey() == 4 && pos.GetValue() == "four"s);
+        assert(!m.Insert(4, "vier"s).second && m.At(4) == "four"s);
+        m[5] += "five"s;
+        assert(m.At(5) == "five"s && m.GetSize() == 5);
+
+        try {
+            m.At(6);
+            assert(false);
+        }
+        catch (const out_of_range&) {
+        }
+        catch (...) {
+            assert(false);
+        }
+
+        // Обход посещает каждый элемент ровно один раз
+        int key_sum = 0;
+        for (const auto [key, value] : m) {
+            key_sum += key;
+            assert(m.At(key) == value);
+        }
+        assert(key_sum == 15);
+
+        assert(m.Erase(1) && !m.Erase(1) && m.GetSize() == 4 && !m.Contains(1));
+        m.Clear();
+        assert(m.IsEmpty() && m.begin() == m.end() && m.GetCapacity() == 16);
+    }
+    {
+        // Reserve выделяет таблицу заранее, после чего вставки не перехешируют её
+        FlatHashMap<int, int> m;
+        m.Reserve(1000);
+        [[maybe_unused]] const size_t capacity = m.GetCapacity();
+        assert(capacity >= 1000 && (capacity & (capacity - 1)) == 0);
+        for (int i = 0; i < 1000; ++i) {
+            m.Insert(i, i * i);
+        }
+        assert(m.GetCapacity() == capacity && m.GetSize() == 1000);
+        for (int i = 0; i < 1000; ++i) {
+            assert(m.At(i) == i * i);
+        }
+    }
+    {
+        // Все ключи в одной цепочке поиска: проверяются переход между группами,
+        // пометки удалённых ячеек и перехеширование таблицы, заполненной удалёнными ячейками
+        std::mt19937 generator(7);
+        FlatHashMap<int, int, ConstantHash> m;
+        std::unordered_map<int, int> reference;
+        for (int step = 0; step < 20000; ++step) {
+            [[maybe_unused]] const int key = static_cast<int>(generator() % 100);
+            if (generator() % 2 == 0) {
+                assert(m.Insert(key, step).second == reference.emplace(key, step).second);
+            }
+            else {
+                assert(m.Erase(key) == (reference.erase(key) == 1));
+            }
+            assert(m.GetSize() == reference.size());
+        }
+        for ([[maybe_unused]] const auto& [key, value] : reference) {
+            assert(m.At(key) == value);
+        }
+        assert(static_cast<size_t>(std::distance(m.begin(), m.end())) == reference.size());
+    }
+    {
+        // Строковые ключи, копирование и перемещение
+        FlatHashMap<string, int> m;
+        for (int i = 0; i < 5000; ++i) {
+            m.Insert("key"s + to_string(i), i);
+        }
+        for (int i = 0; i < 5000; i += 2) {
+            assert(m.Erase("key"s + to_string(i)));
+        }
+        FlatHashMap<string, int> copy(m);
+        assert(copy.GetSize() == 2500);
+        for (int i = 0; i < 5000; ++i) {
+            assert(copy.Contains("key"s + to_string(i)) == (i % 2 == 1));
+        }
+        FlatHashMap<string, int> moved(std::move(copy));
+        assert(moved.GetSize() == 2500 && copy.IsEmpty() && copy.Find("key1"s) == copy.end());
+        copy = moved;
+        assert(copy.At("key4999"s) == 4999);
+        moved = std::move(m);
+        assert(moved.GetSize() == 2500 && m.IsEmpty());
+    }
+    {
+        // Исключение при копировании элементов во время перехеширования не меняет таблицу
+        FlatHashMap<int, MayThrow> m;
+        for (int i = 0; i < 14; ++i) {
+            m.Insert(i, MayThrow(i));
+        }
+        assert(m.GetCapacity() == 16);
+        MayThrow::copies_until_throw = 3;
+        try {
+            m.Insert(14, MayThrow(14));
+            assert(false);
+        }
+        catch (const runtime_error&) {
+        }
+        MayThrow::copies_until_throw = -1;
+        assert(m.GetSize() == 14 && m.GetCapacity() == 16 && !m.Contains(14));
+        for (int i = 0; i < 14; ++i) {
+            assert(m.At(i).value == i);
+        }
+        m.Insert(14, MayThrow(14));
+        assert(m.GetSize() == 15 && m.GetCapacity() == 32 && m.At(14).value == 14);
+    }
+    cout << "Done!"s << endl << endl;
+}
+
+void BenchmarkFlatHashMap() {
+    cout << "BenchmarkFlatHashMap"s << endl;
+    const int count = 200000;
+    const size_t lookups = 1000000;
+    std::mt19937 generator(3);
+    {
+        std::vector<int> keys(count);
+        for (int& key : keys) {
+            key = static_cast<int>(generator());
+        }
+        std::vector<int> probes(lookups);
+        for (int& key : probes) {
+            // половина запросов находит ключ
+            key = generator() % 2 == 0 ? keys[generator() % count] : static_cast<int>(generator());
+        }
+
+        std::unordered_map<int, int> node_map;
+        FlatHashMap<int, int> flat_map;
+        {
+            LOG_DURATION("std::unordered_map insert of 200K int keys"s);
+            for (int i = 0; i < count; ++i) {
+                node_map.emplace(keys[i], i);
+            }
+        }
+        {
+            LOG_DURATION("FlatHashMap insert of 200K int keys"s);
+            for (int i = 0; i < count; ++i) {
+                flat_map.Insert(keys[i], i);
+            }
+        }
+        assert(node_map.size() == flat_map.GetSize());
+        int64_t node_sum = 0;
+        int64_t flat_sum = 0;
+        {
+            LOG_DURATION("std::unordered_map 1M int lookups"s);
+            for (int key : probes) {
+                const auto it = node_map.find(key);
+                node_sum += it != node_map.end() ? it->second : -1;
+            }
+        }
+        {
+            LOG_DURATION("FlatHashMap 1M int lookups"s);
+            for (int key : probes) {
+                const auto it = std::as_const(flat_map).Find(key);
+                flat_sum += it != flat_map.cend() ? it.GetValue() : -1;
+            }
+        }
+        assert(node_sum == flat_sum);
+    }
+    {
+        std::vector<string> keys(count);
+        for (string& key : keys) {
+            key = "user:"s + to_string(generator());
+        }
+        std::vector<string> probes(lookups);
+        for (string& key : probes) {
+            key = generator() % 2 == 0 ? keys[generator() % count] : "user:"s + to_string(generator());
+        }
+
+        std::unordered_map<string, int> node_map;
+        FlatHashMap<string, int> flat_map;
+        {
+            LOG_DURATION("std::unordered_map insert of 200K string keys"s);
+            for (int i = 0; i < count; ++i) {
+                node_map.emplace(keys[i], i);
+            }
+        }
+        {
+            LOG_DURATION("FlatHashMap insert of 200K string keys"s);
+            for (int i = 0; i < count; ++i) {
+                flat_map.Insert(keys[i], i);
+            }
+        }
+        assert(node_map.size() == flat_map.GetSize());
+        int64_t node_sum = 0;
+        int64_t flat_sum = 0;
+        {
+            LOG_DURATION("std::unordered_map 1M string lookups"s);
+            for (const string& key : probes) {
+                const auto it = node_map.find(key);
+                node_sum += it != node_map.end() ? it->second : -1;
+            }
+        }
+        {
+            LOG_DURATION("FlatHashMap 1M string lookups"s);
+            for (const string& key : probes) {
+                const auto it = std::as_const(flat_map).Find(key);
+                flat_sum += it != flat_map.cend() ? it.GetValue() : -1;
+            }
+        }
+        assert(node_sum == flat_sum);
     }
     cout << "Done!"s << endl << endl;
 }
@@ -635,5 +8831,45 @@ int main() {
     TestNoncopiableInsert();
     TestNoncopiableErase();
     TestResizeMethodNoCopy();
+    TestRawMemoryStorage();
+    TestEmplace();
+    TestTriviallyRelocatable();
+    TestSmallVector();
+    BenchmarkSmallVector();
+    TestCustomAllocator();
+    TestGrowthPolicy();
+    BenchmarkGrowthPolicies();
+    TestShrinkToFit();
+    TestRangeOperations();
+    BenchmarkRangeInsert();
+    TestGrowthExceptionSafety();
+    TestSimdComparisons();
+    BenchmarkComparisons();
+    TestParallelConstruction();
+    BenchmarkParallelConstruction();
+    TestAlignedAllocation();
+#ifdef SIMPLE_VECTOR_HAS_MMAP
+    TestMappedVector();
+#endif
+    TestBinarySerialization();
+    TestCowVector();
+    TestSegmentedVector();
+    BenchmarkSegmentedVector();
+    TestSoAVector();
+    BenchmarkSoAVector();
+    TestInplaceVector();
+#ifdef __cpp_lib_constexpr_dynamic_alloc
+    TestConstexprSimpleVector();
+#endif
+    TestConcurrentVector();
+    BenchmarkConcurrentVector();
+    TestAppendUninitialized();
+    BenchmarkAppendUninitialized();
+    TestCheckedIterators();
+    TestFlatMap();
+    TestFlatSet();
+    BenchmarkFlatMap();
+    TestFlatHashMap();
+    BenchmarkFlatHashMap();
     return 0;
 }
\ No newline at end of file